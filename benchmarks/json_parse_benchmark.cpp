@@ -0,0 +1,186 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+
+#include "json.h"
+#include "legacy_json_load.h"
+
+// Пропускная способность разбора JSON на документе вида base_requests: текущий json::Load
+// и прежний загрузчик с повторным просмотром подстрок (legacy_json_load.h) на одних и тех же данных.
+// Запуск: json_parse_benchmark [число остановок] [число повторов], по умолчанию 100000 и 3.
+// Для каждого способа печатается лучший из повторов. Код возврата 1, если документы,
+// прочитанные из потока, из буфера и прежним загрузчиком, различаются или печать прочитанного
+// не совпадает со входом
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+	// Остановки с тремя расстояниями и маршруты по 20 случайных остановок, как во входных данных программы
+	std::string GenerateDocument(size_t stop_count) {
+		std::mt19937 random(1);
+		std::uniform_int_distribution<size_t> stop(0, stop_count - 1);
+		std::uniform_int_distribution<int> distance(100, 5000);
+		std::uniform_real_distribution<double> offset(0, 1);
+		const auto stop_name = [](size_t id) { return "Stop " + std::to_string(id) + " ulitsa Lenina"; };
+
+		json::Array base_requests;
+		for (size_t id = 0; id < stop_count; ++id) {
+			json::Dict road_distances;
+			for (int i = 0; i < 3; ++i) {
+				road_distances.emplace(stop_name(stop(random)), distance(random));
+			}
+			json::Dict request;
+			request.emplace("type", std::string("Stop"));
+			request.emplace("name", stop_name(id));
+			request.emplace("latitude", 55 + offset(random));
+			request.emplace("longitude", 37 + offset(random));
+			request.emplace("road_distances", std::move(road_distances));
+			base_requests.emplace_back(std::move(request));
+		}
+		for (size_t id = 0; id < stop_count / 10; ++id) {
+			json::Array stops;
+			for (int i = 0; i < 20; ++i) {
+				stops.emplace_back(stop_name(stop(random)));
+			}
+			json::Dict request;
+			request.emplace("type", std::string("Bus"));
+			request.emplace("name", "Bus " + std::to_string(id));
+			request.emplace("stops", std::move(stops));
+			request.emplace("is_roundtrip", false);
+			base_requests.emplace_back(std::move(request));
+		}
+		json::Dict root;
+		root.emplace("base_requests", std::move(base_requests));
+
+		std::ostringstream output;
+		json::PrintNode(json::Node{ std::move(root) }, output);
+		return output.str();
+	}
+
+	// Обработчик без действий: замеряет только разбор, без построения дерева
+	class NullHandler : public json::Handler {
+	public:
+		void StartMap() override {}
+		void Key(std::string_view) override {}
+		void EndMap() override {}
+		void StartArray() override {}
+		void EndArray() override {}
+		void Value(json::Node) override {}
+	};
+
+	// Дерево прежнего загрузчика в узлах json для сравнения с json::Load
+	json::Node ToNode(const legacy_json::Node& node) {
+		if (const auto* array = std::get_if<legacy_json::Array>(&node)) {
+			json::Array result;
+			for (const legacy_json::Node& item : *array) {
+				result.push_back(ToNode(item));
+			}
+			return result;
+		}
+		if (const auto* dict = std::get_if<legacy_json::Dict>(&node)) {
+			json::Dict result;
+			for (const auto& [key, value] : *dict) {
+				result.emplace(key, ToNode(value));
+			}
+			return result;
+		}
+		if (const auto* value = std::get_if<std::string>(&node)) {
+			return *value;
+		}
+		if (const auto* value = std::get_if<double>(&node)) {
+			return *value;
+		}
+		if (const auto* value = std::get_if<int>(&node)) {
+			return *value;
+		}
+		if (const auto* value = std::get_if<bool>(&node)) {
+			return *value;
+		}
+		return nullptr;
+	}
+
+	template <typename Action>
+	double BestSeconds(int repeats, Action action) {
+		double best = 0;
+		for (int i = 0; i < repeats; ++i) {
+			const auto start = Clock::now();
+			action();
+			const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+			best = i == 0 ? seconds : std::min(best, seconds);
+		}
+		return best;
+	}
+
+	void Report(std::string_view name, size_t bytes, double seconds) {
+		std::cout << std::left << std::setw(28) << name << std::right << std::fixed << std::setprecision(4)
+			<< std::setw(9) << seconds << " s" << std::setprecision(1)
+			<< std::setw(10) << static_cast<double>(bytes) / 1e6 / seconds << " MB/s\n";
+	}
+} // namespace
+
+int main(int argc, char** argv) {
+	const size_t stop_count = std::max<size_t>(argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000, 1);
+	const int repeats = std::max(argc > 2 ? std::atoi(argv[2]) : 3, 1);
+
+	const std::string text = GenerateDocument(stop_count);
+	std::cout << stop_count << " stops, " << std::fixed << std::setprecision(1)
+		<< static_cast<double>(text.size()) / 1e6 << " MB, best of " << repeats << "\n";
+
+	Report("json::Load(std::istream&)", text.size(), BestSeconds(repeats, [&] {
+		std::istringstream input(text);
+		const json::Document document = json::Load(input);
+		static_cast<void>(document);
+	}));
+	Report("json::Load(std::string)", text.size(), BestSeconds(repeats, [&] {
+		const json::Document document = json::Load(std::string(text));
+		static_cast<void>(document);
+	}));
+	Report("json::Parse, no tree", text.size(), BestSeconds(repeats, [&] {
+		NullHandler handler;
+		json::Parse(std::string_view(text), handler);
+	}));
+	Report("legacy Load(std::istream&)", text.size(), BestSeconds(repeats, [&] {
+		std::istringstream input(text);
+		const legacy_json::Node root = legacy_json::Load(input);
+		static_cast<void>(root);
+	}));
+
+	std::istringstream stream_input(text);
+	const json::Document document = json::Load(stream_input);
+	std::ostringstream printed;
+	json::Print(document, printed);
+	std::istringstream legacy_input(text);
+	const bool ok = printed.str() == text && document == json::Load(std::string(text))
+		&& document.GetRoot() == ToNode(legacy_json::Load(legacy_input));
+
+	// Глубокая вложенность: у json::Load время линейно, прежний загрузчик просматривает
+	// подстроку заново на каждом уровне. При вчетверо большей глубине линейное время
+	// растёт вчетверо, квадратичное - в 16 раз
+	for (const size_t depth : { 750, 3000 }) {
+		const std::string nested = std::string(depth, '[') + "1" + std::string(depth, ']');
+		Report("nested array, depth " + std::to_string(depth), nested.size(), BestSeconds(repeats, [&] {
+			const json::Document document = json::Load(std::string(nested));
+			static_cast<void>(document);
+		}));
+		Report("legacy nested, depth " + std::to_string(depth), nested.size(), BestSeconds(repeats, [&] {
+			std::istringstream input(nested);
+			const legacy_json::Node root = legacy_json::Load(input);
+			static_cast<void>(root);
+		}));
+	}
+
+	if (!ok) {
+		std::cerr << "Documents differ between stream, buffer and legacy input or after printing\n";
+		return 1;
+	}
+	return 0;
+}
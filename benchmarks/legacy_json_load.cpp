@@ -0,0 +1,224 @@
+#include "legacy_json_load.h"
+
+#include <algorithm>
+#include <cctype>
+#include <iterator>
+#include <string_view>
+#include <utility>
+
+#include "json.h"
+
+namespace legacy_json {
+
+	using json::ParsingError;
+
+	namespace detail {
+
+		Node LoadNode(std::string_view input);
+		std::string StringParsing(std::string_view str);
+
+		using Iterator = std::string_view::iterator;
+
+		std::pair<std::string_view, Node> ParsePair(std::string_view input) {
+			auto key_start = std::ranges::find(input, '\"');
+			auto key_end = std::find(++key_start, input.end(), '\"');
+			auto value_start = std::find(key_end, input.end(), ':') + 1;
+
+			std::string_view key(&(*key_start), key_end - key_start);
+			std::string_view value(&(*value_start), input.end() - value_start);
+
+			return std::make_pair(key, LoadNode(value));
+		}
+
+		Iterator FindMatchingBracket(std::string_view input, Iterator start, char op_bracket, char cl_bracket) {
+			int count = 1;
+			auto it = start + 1;
+			while (count > 0 && it != input.end()) {
+				count += *it == op_bracket ? 1 : *it == cl_bracket ? -1 : 0;
+				++it;
+			}
+			if (count != 0) {
+				throw ParsingError("Unmatched bracket");
+			}
+			return it;
+		}
+
+		Iterator FindValueEnd(std::string_view input, Iterator start) {
+			auto comma_pos = std::find(start, input.end(), ',');
+			auto bracket_op = std::find_if(start, comma_pos, [](const auto& c) {return c == '[' || c == '{'; });
+			if (bracket_op != comma_pos) {
+				char cl_bracket = *bracket_op == '{' ? '}' : ']';
+				return FindMatchingBracket(input, bracket_op, *bracket_op, cl_bracket);
+			}
+			return comma_pos;
+		}
+
+		Node LoadArray(std::string_view input) {
+			Array result;
+
+			auto start_pos = input.begin();
+			while (true) {
+				start_pos = std::find_if(start_pos, input.end(), [](const auto& c) {return c != ' ' && c != ','; });
+				if (start_pos == input.end()) {
+					break;
+				}
+
+				if (*start_pos == '{' || *start_pos == '[') {
+					char cl_bracket = *start_pos == '{' ? '}' : ']';
+					auto it = FindMatchingBracket(input, start_pos, *start_pos, cl_bracket);
+					result.emplace_back(LoadNode({ start_pos, it }));
+					start_pos = it == input.end() ? input.end() : ++it;
+					continue;
+				}
+
+				auto end_pos = std::find(start_pos, input.end(), ',');
+
+				std::string_view sub_str(&(*start_pos), end_pos - start_pos);
+				result.emplace_back(LoadNode(sub_str));
+				start_pos = end_pos;
+			}
+			return Node{ std::move(result) };
+		}
+
+		Node LoadMap(std::string_view input) {
+			Dict result;
+			auto start_pos = input.begin();
+			while (true) {
+				start_pos = std::find_if(start_pos, input.end(), [](const auto& c) {return c != ' ' && c != ','; });
+				if (start_pos == input.end()) {
+					break;
+				}
+
+				if (*start_pos == '{' || *start_pos == '[') {
+					char cl_bracket = *start_pos == '{' ? '}' : ']';
+					auto it = FindMatchingBracket(input, start_pos, *start_pos, cl_bracket);
+					result.emplace(ParsePair({ start_pos, it }));
+					start_pos = it == input.end() ? input.end() : ++it;
+					continue;
+				}
+
+				auto colon = std::find(start_pos, input.end(), ':');
+				auto end_pos = FindValueEnd(input, std::next(colon));
+
+				std::string_view sub_str(&(*start_pos), end_pos - start_pos);
+				result.emplace(ParsePair(sub_str));
+				start_pos = end_pos;
+			}
+			return Node{ std::move(result) };
+		}
+
+		Node LoadNumber(std::string_view input) {
+			auto invalid_symbol = [](char c) {return !std::isdigit(static_cast<unsigned char>(c)) && (c != '.' && c != '+' && c != '-' && c != 'e' && c != 'E'); };
+			if (std::ranges::find_if(input, invalid_symbol) != input.end()) {
+				throw ParsingError("Invalid Number");
+			}
+
+			std::string str{ input };
+
+			double num_d = std::stod(str);
+			int num_i = static_cast<int>(num_d);
+
+			auto is_double = [](char c) {return c == '.' || c == 'e' || c == 'E'; };
+
+			if (std::ranges::find_if(str, is_double) != str.end()) {
+				return Node{ num_d };
+			}
+
+			return Node{ num_i };
+		}
+
+		Node LoadPrimitive(std::string_view input) {
+			auto predicate = [](char c) {return c == ']' || c == '}'; };
+			if (std::ranges::find_if(input, predicate) != input.end()) {
+				throw ParsingError("Invalid Primitive");
+			}
+
+			if (input == "null") {
+				return Node{ nullptr };
+			}
+
+			if (input == "true" || input == "false") {
+				return input == "true" ? Node{ true } : Node{ false };
+			}
+
+			return LoadNumber(input);
+		}
+
+		// Закрывающая скобка ищется с конца подстроки: на каждом уровне вложенности
+		// подстрока просматривается заново
+		Node LoadNode(std::string_view input) {
+			if (input.empty()) {
+				return {};
+			}
+
+			auto predicate = [](char c) {return c != '\n' && c != '\r' && c != '\t' && c != ' '; };
+			auto it_first_symbol = std::find_if(input.begin(), input.end(), predicate);
+			auto it_last_symbol = input.end();
+			if (*it_first_symbol == '{') {
+				auto rfound = std::find(input.rbegin(), input.rend(), '}');
+				if (rfound == input.rend()) {
+					throw ParsingError("Invalid Dict");
+				}
+				auto offset = std::distance(rfound, input.rbegin());
+				it_last_symbol = it_last_symbol + offset;
+				return LoadMap({ ++it_first_symbol, --it_last_symbol });
+			}
+
+			if (*it_first_symbol == '[') {
+				auto rfound = std::find(input.rbegin(), input.rend(), ']');
+				if (rfound == input.rend()) {
+					throw ParsingError("Invalid Array");
+				}
+				auto offset = std::distance(rfound, input.rbegin());
+				it_last_symbol = it_last_symbol + offset;
+				return LoadArray({ ++it_first_symbol, --it_last_symbol });
+			}
+
+			if (*it_first_symbol == '\"') {
+				auto rfound = std::find(input.rbegin(), input.rend(), '\"');
+				auto offset = std::distance(rfound, input.rbegin());
+				it_last_symbol = it_last_symbol + offset;
+				if (++it_first_symbol > --it_last_symbol) {
+					throw ParsingError("Invalid String");
+				}
+				return Node{ StringParsing({ it_first_symbol, it_last_symbol }) };
+			}
+
+			auto offset = std::distance(std::find_if(input.rbegin(), input.rend(), predicate), input.rbegin());
+			it_last_symbol = it_last_symbol + offset;
+
+			return LoadPrimitive({ it_first_symbol, it_last_symbol });
+		}
+
+		std::string StringParsing(std::string_view input) {
+			std::string str;
+			for (auto it = input.begin(); it != input.end(); ++it) {
+				if (*it == '\\' && std::next(it) != input.end()) {
+					switch (*++it) {
+					case 'r':  str += '\r'; break;
+					case 'n':  str += '\n'; break;
+					case 't':  str += '\t'; break;
+					case '"':  str += '\"'; break;
+					case '\\': str += '\\'; break;
+					default:   str += '\\'; str += *it;  // недопустимый escape
+					}
+				} else {
+					str += *it;
+				}
+			}
+			return str;
+		}
+
+	}  // namespace detail
+
+	Node Load(std::istream& input) {
+		std::string str;
+		while (input.good()) {
+			std::string temp;
+			std::getline(input, temp);
+			str += temp;
+		}
+		return detail::LoadNode(str);
+	}
+
+}  // namespace legacy_json
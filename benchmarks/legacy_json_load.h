@@ -0,0 +1,29 @@
+#pragma once
+
+#include <istream>
+#include <map>
+#include <string>
+#include <variant>
+#include <vector>
+
+// Загрузчик JSON в том виде, в каком он был до однопроходного json::Load: поток читается
+// в строку целиком, а конец каждого вложенного значения ищется повторным просмотром подстроки.
+// Собирается только в json_parse_benchmark, чтобы сравнение со старым разбором
+// воспроизводилось из дерева, и не входит в transport_catalogue_lib
+
+namespace legacy_json {
+
+	class Node;
+	using Dict = std::map<std::string, Node>;
+	using Array = std::vector<Node>;
+
+	class Node
+		: public std::variant<std::nullptr_t, bool, int, double, std::string, Array, Dict> {
+	public:
+		using variant::variant;
+	};
+
+	// Ошибки разбора - json::ParsingError, как у прежнего json::Load
+	Node Load(std::istream& input);
+
+}  // namespace legacy_json
@@ -0,0 +1,142 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <numbers>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "geo.h"
+#include "point_index.h"
+
+// Сравнение geo::PointIndex с перебором всех точек: время на запрос и совпадение ответов.
+// Запуск: point_index_benchmark [число точек] [число запросов], по умолчанию 100000 и 1000.
+// Код возврата 1, если хотя бы один ответ индекса отличается от перебора
+
+using geo::Coordinates;
+using geo::PointDistance;
+using geo::PointIndex;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+	struct Area {
+		std::string name;
+		// Точки и центры запросов: по всему шару или в квадрате вокруг центра города
+		bool globe = false;
+		Coordinates center{};
+		double half_size = 0;
+		double radius = 0;
+	};
+
+	Coordinates RandomPoint(const Area& area, std::mt19937& random) {
+		std::uniform_real_distribution<double> unit(0, 1);
+		if (area.globe) {
+			// Равномерно по поверхности сферы, а не по широте
+			const double latitude = std::asin(2 * unit(random) - 1) * 180 / std::numbers::pi;
+			return { latitude, 360 * unit(random) - 180 };
+		}
+		return { area.center.lat + area.half_size * (2 * unit(random) - 1),
+			area.center.lng + area.half_size * (2 * unit(random) - 1) };
+	}
+
+	void SortByDistance(std::vector<PointDistance>& points) {
+		std::ranges::sort(points, {}, [](const PointDistance& point) { return std::pair{ point.distance, point.id }; });
+	}
+
+	std::vector<PointDistance> ScanInRadius(const std::vector<Coordinates>& points, Coordinates center, double radius) {
+		std::vector<PointDistance> result;
+		for (uint32_t id = 0; id < points.size(); ++id) {
+			if (const double distance = geo::ComputeDistance(center, points[id]); distance <= radius) {
+				result.push_back({ id, distance });
+			}
+		}
+		SortByDistance(result);
+		return result;
+	}
+
+	std::vector<PointDistance> ScanNearest(const std::vector<Coordinates>& points, Coordinates center, size_t count) {
+		std::vector<PointDistance> result;
+		result.reserve(points.size());
+		for (uint32_t id = 0; id < points.size(); ++id) {
+			result.push_back({ id, geo::ComputeDistance(center, points[id]) });
+		}
+		SortByDistance(result);
+		result.resize(std::min(result.size(), count));
+		return result;
+	}
+
+	bool Equal(const std::vector<PointDistance>& lhs, const std::vector<PointDistance>& rhs) {
+		return std::ranges::equal(lhs, rhs, [](const PointDistance& a, const PointDistance& b) {
+			return a.id == b.id && a.distance == b.distance;
+		});
+	}
+
+	double MicrosecondsPerQuery(Clock::duration elapsed, size_t queries) {
+		return std::chrono::duration<double, std::micro>(elapsed).count() / static_cast<double>(queries);
+	}
+
+	// Прогоняет одни и те же центры через индекс и перебор, возвращает число расхождений
+	template <typename IndexQuery, typename ScanQuery>
+	size_t Run(const std::string& name, const std::vector<Coordinates>& centers, IndexQuery index_query, ScanQuery scan_query) {
+		std::vector<std::vector<PointDistance>> index_answers;
+		const auto index_start = Clock::now();
+		for (const Coordinates& center : centers) {
+			index_answers.push_back(index_query(center));
+		}
+		const auto index_elapsed = Clock::now() - index_start;
+
+		size_t mismatches = 0;
+		const auto scan_start = Clock::now();
+		for (size_t i = 0; i < centers.size(); ++i) {
+			mismatches += Equal(index_answers[i], scan_query(centers[i])) ? 0 : 1;
+		}
+		const auto scan_elapsed = Clock::now() - scan_start;
+
+		std::cout << std::left << std::setw(24) << name << std::right << std::fixed << std::setprecision(1)
+			<< std::setw(10) << MicrosecondsPerQuery(index_elapsed, centers.size()) << " us"
+			<< std::setw(12) << MicrosecondsPerQuery(scan_elapsed, centers.size()) << " us"
+			<< (mismatches == 0 ? "" : "  MISMATCH: " + std::to_string(mismatches)) << "\n";
+		return mismatches;
+	}
+} // namespace
+
+int main(int argc, char** argv) {
+	const size_t point_count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+	const size_t query_count = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1000;
+	constexpr size_t NEAREST_COUNT = 10;
+
+	const std::vector<Area> areas{
+		{ .name = "globe", .globe = true, .radius = 100000 },
+		{ .name = "city", .center = { 55.75, 37.6 }, .half_size = 0.2, .radius = 500 }
+	};
+
+	std::cout << point_count << " points, " << query_count << " queries\n"
+		<< std::left << std::setw(24) << "query" << std::right << std::setw(13) << "index" << std::setw(15) << "linear scan" << "\n";
+	size_t mismatches = 0;
+	std::mt19937 random(2024);
+	for (const Area& area : areas) {
+		std::vector<Coordinates> points(point_count);
+		std::vector<Coordinates> centers(query_count);
+		std::ranges::generate(points, [&] { return RandomPoint(area, random); });
+		std::ranges::generate(centers, [&] { return RandomPoint(area, random); });
+
+		const auto build_start = Clock::now();
+		const PointIndex index(points);
+		std::cout << std::left << std::setw(24) << area.name + ", build" << std::right << std::fixed << std::setprecision(1)
+			<< std::setw(10) << std::chrono::duration<double, std::milli>(Clock::now() - build_start).count() << " ms\n";
+
+		mismatches += Run(area.name + ", radius " + std::to_string(static_cast<int>(area.radius)) + " m", centers,
+			[&](Coordinates center) { return index.FindInRadius(center, area.radius); },
+			[&](Coordinates center) { return ScanInRadius(points, center, area.radius); });
+		mismatches += Run(area.name + ", nearest " + std::to_string(NEAREST_COUNT), centers,
+			[&](Coordinates center) { return index.FindNearest(center, NEAREST_COUNT); },
+			[&](Coordinates center) { return ScanNearest(points, center, NEAREST_COUNT); });
+	}
+	return mismatches == 0 ? 0 : 1;
+}
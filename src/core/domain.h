@@ -1,45 +1,61 @@
-#pragma once
-
-#include <string>
-#include <string_view>
-#include <vector>
-
-#include "geo.h"
-
-// Описывает остановку общественного транспорта
-struct BusStop {
-	std::string name;
-	geo::Coordinates geo_point;
-
-	bool empty() const {
-		return name.empty();
-	}
-};
-
-// Описывает маршрут движения транспорта между остановками
-struct Route {
-	std::string name;
-	std::vector<const BusStop*> driving_route;
-	bool round_trip = false;
-
-	bool empty() const {
-		return name.empty();
-	}
-};
-
-// Содержит агрегированные статистические данные о маршруте
-struct InfoRoute {
-	std::string_view name;
-	int number_total = 0;
-	int number_unique = 0;
-	double route_length = 0;
-	double curvature = 0;
-};
-
-// Содержит информацию о маршрутах, проходящих через остановку
-struct InfoStop {
-	std::string_view name;
-	std::vector<std::string_view> cross_references;
-};
-
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "geo.h"
+
+// Плотные номера, которые TransportCatalogue назначает в порядке добавления: 0, 1, 2, ...
+// Подходят для индексации векторов вместо хэш-таблиц по указателям и именам
+using StopId = uint32_t;
+using RouteId = uint32_t;
+
+// Описывает остановку общественного транспорта
+struct BusStop {
+	std::string name;
+	geo::Coordinates geo_point;
+	// geo_point единичным вектором, заполняет TransportCatalogue::AddStop
+	geo::UnitVector unit_vector{};
+	StopId id = 0;
+
+	bool empty() const {
+		return name.empty();
+	}
+};
+
+// Описывает маршрут движения транспорта между остановками
+struct Route {
+	std::string name;
+	std::vector<const BusStop*> driving_route;
+	bool round_trip = false;
+	RouteId id = 0;
+
+	bool empty() const {
+		return name.empty();
+	}
+};
+
+// Содержит агрегированные статистические данные о маршруте
+struct InfoRoute {
+	std::string_view name;
+	int number_total = 0;
+	int number_unique = 0;
+	double route_length = 0;
+	double curvature = 0;
+};
+
+// Содержит информацию о маршрутах, проходящих через остановку
+struct InfoStop {
+	std::string_view name;
+	std::vector<std::string_view> cross_references;
+};
+
+// Остановка и расстояние до неё в метрах по поверхности Земли
+struct StopDistance {
+	const BusStop* stop = nullptr;
+	double distance = 0;
+};
+
 using BusStopPair = std::pair<const BusStop*, const BusStop*>; // {from, to}
\ No newline at end of file
@@ -1,14 +1,75 @@
-#include "geo.h"
-
-namespace geo {
-	double ComputeDistance(Coordinates from, Coordinates to) {
-		using namespace std;
-		if (from == to) {
-			return 0;
-		}
-		static const double dr = 3.1415926535 / 180.;
-		return acos(sin(from.lat * dr) * sin(to.lat * dr)
-			+ cos(from.lat * dr) * cos(to.lat * dr) * cos(abs(from.lng - to.lng) * dr))
-			* 6371000;
-	}
-} //namespace geo
+#include "geo.h"
+
+#include <cassert>
+#include <vector>
+
+namespace geo {
+	namespace {
+		// Квадрат хорды между точками: у совпадающих точек ровно 0, и для близких точек
+		// нет потери точности, как у скалярного произведения, близкого к 1
+		double ComputeSquaredChord(const UnitVector& from, const UnitVector& to) {
+			const double dx = from.x - to.x;
+			const double dy = from.y - to.y;
+			const double dz = from.z - to.z;
+			return dx * dx + dy * dy + dz * dz;
+		}
+
+		// Дуга по хорде: угол 2 * asin(chord / 2). Ограничение сверху - от округления у противоположных точек
+		double ChordToDistance(double squared_chord) {
+			return 2 * std::asin(std::min(std::sqrt(squared_chord) / 2, 1.)) * EARTH_RADIUS;
+		}
+	} // namespace
+
+	double ComputeDistance(Coordinates from, Coordinates to) {
+		using namespace std;
+		if (from == to) {
+			return 0;
+		}
+		static const double dr = DEGREES_TO_RADIANS;
+		return acos(sin(from.lat * dr) * sin(to.lat * dr)
+			+ cos(from.lat * dr) * cos(to.lat * dr) * cos(abs(from.lng - to.lng) * dr))
+			* EARTH_RADIUS;
+	}
+
+	UnitVector ToUnitVector(Coordinates point) {
+		const double lat = point.lat * DEGREES_TO_RADIANS;
+		const double lng = point.lng * DEGREES_TO_RADIANS;
+		return { std::cos(lat) * std::cos(lng), std::cos(lat) * std::sin(lng), std::sin(lat) };
+	}
+
+	double ComputeDistance(const UnitVector& from, const UnitVector& to) {
+		return ChordToDistance(ComputeSquaredChord(from, to));
+	}
+
+	// Хорды и арксинусы считаются отдельными проходами:
+	// первый цикл векторизуется всегда, второй - при наличии векторного asin в libm
+	void ComputeDistances(std::span<const UnitVector> points, std::span<double> distances) {
+		if (points.empty()) {
+			return;
+		}
+		const size_t count = points.size() - 1;
+		assert(distances.size() == count);
+		const UnitVector* from = points.data();
+		const UnitVector* to = points.data() + 1;
+		double* result = distances.data();
+		for (size_t i = 0; i < count; ++i) {
+			result[i] = ComputeSquaredChord(from[i], to[i]);
+		}
+		for (size_t i = 0; i < count; ++i) {
+			result[i] = ChordToDistance(result[i]);
+		}
+	}
+
+	double ComputeLength(std::span<const UnitVector> points) {
+		if (points.size() < 2) {
+			return 0;
+		}
+		std::vector<double> distances(points.size() - 1);
+		ComputeDistances(points, distances);
+		double length = 0;
+		for (const double distance : distances) {
+			length += distance;
+		}
+		return length;
+	}
+} //namespace geo
@@ -1,19 +1,50 @@
-#pragma once
-
-#include <cmath>
-#include <algorithm>
-
-namespace geo {
-	struct Coordinates {
-		double lat;
-		double lng;
-		bool operator==(const Coordinates& other) const {
-			return lat == other.lat && lng == other.lng;
-		}
-		bool operator!=(const Coordinates& other) const {
-			return !(*this == other);
-		}
-	};
-
-	double ComputeDistance(Coordinates from, Coordinates to);
-} // namespace geo
\ No newline at end of file
+#pragma once
+
+#include <cmath>
+#include <algorithm>
+#include <span>
+
+namespace geo {
+	// Радиус Земли в метрах и множитель перевода градусов в радианы, которые использует ComputeDistance
+	inline constexpr double EARTH_RADIUS = 6371000;
+	inline constexpr double DEGREES_TO_RADIANS = 3.1415926535 / 180.;
+	// Наибольшая разница в метрах между расстояниями по координатам и по единичным векторам.
+	// Разница - погрешность арккосинуса в ComputeDistance по координатам: у близких точек
+	// косинус почти равен 1 и теряет значащие цифры. Для точек дальше 100 м разница меньше 1 мм
+	inline constexpr double UNIT_VECTOR_TOLERANCE = 0.2;
+
+	struct Coordinates {
+		double lat;
+		double lng;
+		bool operator==(const Coordinates& other) const {
+			return lat == other.lat && lng == other.lng;
+		}
+		bool operator!=(const Coordinates& other) const {
+			return !(*this == other);
+		}
+	};
+
+	// Точка сферы единичным вектором в трёхмерном пространстве.
+	// Угол между точками выражается через хорду между векторами, поэтому
+	// синусы и косинусы вычисляются один раз на точку, а не на каждую пару
+	struct UnitVector {
+		double x = 0;
+		double y = 0;
+		double z = 0;
+	};
+
+	double ComputeDistance(Coordinates from, Coordinates to);
+
+	UnitVector ToUnitVector(Coordinates point);
+
+	// Расстояние по заранее вычисленным векторам, от ComputeDistance по координатам
+	// отличается не больше чем на UNIT_VECTOR_TOLERANCE
+	double ComputeDistance(const UnitVector& from, const UnitVector& to);
+
+	// Расстояния между соседними точками: distances[i] - от points[i] до points[i + 1],
+	// размер distances - points.size() - 1. Циклы без ветвлений, компилятор их векторизует
+	void ComputeDistances(std::span<const UnitVector> points, std::span<double> distances);
+
+	// Длина ломаной через points
+	double ComputeLength(std::span<const UnitVector> points);
+} // namespace geo
@@ -0,0 +1,175 @@
+#include "point_index.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numbers>
+#include <queue>
+#include <utility>
+
+namespace geo {
+	namespace {
+		// Запас на погрешность округления между хордой и формулой ComputeDistance, радиан
+		constexpr double ANGLE_MARGIN = 1e-7;
+
+		void ToUnitVector(Coordinates point, double (&position)[3]) {
+			const UnitVector vector = geo::ToUnitVector(point);
+			position[0] = vector.x;
+			position[1] = vector.y;
+			position[2] = vector.z;
+		}
+
+		double SquaredChord(const double (&a)[3], const double (&b)[3]) {
+			const double dx = a[0] - b[0];
+			const double dy = a[1] - b[1];
+			const double dz = a[2] - b[2];
+			return dx * dx + dy * dy + dz * dz;
+		}
+
+		// Длина хорды, стягивающей дугу в distance метров с запасом
+		double ChordForDistance(double distance) {
+			const double angle = std::min(distance / EARTH_RADIUS + ANGLE_MARGIN, std::numbers::pi);
+			return 2 * std::sin(angle / 2);
+		}
+
+		void SortByDistance(std::vector<PointDistance>& points) {
+			std::ranges::sort(points, [](const PointDistance& lhs, const PointDistance& rhs) {
+				return std::pair{ lhs.distance, lhs.id } < std::pair{ rhs.distance, rhs.id };
+			});
+		}
+	} // namespace
+
+	PointIndex::PointIndex(const std::vector<Coordinates>& points) {
+		nodes_.reserve(points.size());
+		for (uint32_t id = 0; id < points.size(); ++id) {
+			Node node{ .position{}, .point = points[id], .id = id, .axis = 0 };
+			ToUnitVector(points[id], node.position);
+			nodes_.push_back(node);
+		}
+		Build(0, nodes_.size());
+	}
+
+	// Ось разбиения - ось наибольшего разброса точек отрезка
+	void PointIndex::Build(size_t begin, size_t end) {
+		if (end - begin <= 1) {
+			return;
+		}
+		double low[3] = { nodes_[begin].position[0], nodes_[begin].position[1], nodes_[begin].position[2] };
+		double high[3] = { low[0], low[1], low[2] };
+		for (size_t i = begin + 1; i < end; ++i) {
+			for (int axis = 0; axis < 3; ++axis) {
+				low[axis] = std::min(low[axis], nodes_[i].position[axis]);
+				high[axis] = std::max(high[axis], nodes_[i].position[axis]);
+			}
+		}
+		uint8_t axis = 0;
+		for (uint8_t candidate = 1; candidate < 3; ++candidate) {
+			if (high[candidate] - low[candidate] > high[axis] - low[axis]) {
+				axis = candidate;
+			}
+		}
+
+		const size_t middle = begin + (end - begin) / 2;
+		std::nth_element(nodes_.begin() + begin, nodes_.begin() + middle, nodes_.begin() + end,
+			[axis](const Node& lhs, const Node& rhs) { return lhs.position[axis] < rhs.position[axis]; });
+		nodes_[middle].axis = axis;
+		Build(begin, middle);
+		Build(middle + 1, end);
+	}
+
+	std::vector<PointDistance> PointIndex::FindInRadius(Coordinates center, double radius) const {
+		std::vector<PointDistance> result;
+		if (radius < 0) {
+			return result;
+		}
+		double target[3];
+		ToUnitVector(center, target);
+		std::vector<size_t> candidates;
+		CollectInRadius(0, nodes_.size(), target, ChordForDistance(radius), candidates);
+		for (const size_t index : candidates) {
+			const double distance = ComputeDistance(center, nodes_[index].point);
+			if (distance <= radius) {
+				result.push_back({ nodes_[index].id, distance });
+			}
+		}
+		SortByDistance(result);
+		return result;
+	}
+
+	void PointIndex::CollectInRadius(size_t begin, size_t end, const double (&target)[3], double chord,
+		std::vector<size_t>& result) const {
+		while (begin < end) {
+			const size_t middle = begin + (end - begin) / 2;
+			const Node& node = nodes_[middle];
+			if (SquaredChord(node.position, target) <= chord * chord) {
+				result.push_back(middle);
+			}
+			const double offset = target[node.axis] - node.position[node.axis];
+			// Ближняя к цели половина обходится циклом, дальняя - только если её задевает шар
+			if (offset < 0) {
+				if (-offset <= chord) {
+					CollectInRadius(middle + 1, end, target, chord, result);
+				}
+				end = middle;
+			} else {
+				if (offset <= chord) {
+					CollectInRadius(begin, middle, target, chord, result);
+				}
+				begin = middle + 1;
+			}
+		}
+	}
+
+	std::vector<PointDistance> PointIndex::FindNearest(Coordinates center, size_t count) const {
+		std::vector<PointDistance> result;
+		count = std::min(count, nodes_.size());
+		if (count == 0) {
+			return result;
+		}
+		double target[3];
+		ToUnitVector(center, target);
+
+		// Куча из count лучших кандидатов, на вершине - самый дальний
+		using Candidate = std::pair<double, size_t>;
+		std::priority_queue<Candidate> best;
+		double bound = std::numeric_limits<double>::infinity();
+		auto visit = [&](size_t index, double squared_chord) {
+			if (best.size() < count) {
+				best.emplace(squared_chord, index);
+			} else if (squared_chord < best.top().first) {
+				best.pop();
+				best.emplace(squared_chord, index);
+			}
+			if (best.size() == count) {
+				bound = best.top().first;
+			}
+		};
+		VisitNearest(0, nodes_.size(), target, bound, visit);
+
+		while (!best.empty()) {
+			const Node& node = nodes_[best.top().second];
+			result.push_back({ node.id, ComputeDistance(center, node.point) });
+			best.pop();
+		}
+		SortByDistance(result);
+		return result;
+	}
+
+	// bound - квадрат хорды до самого дальнего из найденных кандидатов
+	template <typename Visit>
+	void PointIndex::VisitNearest(size_t begin, size_t end, const double (&target)[3], double& bound, Visit& visit) const {
+		if (begin >= end) {
+			return;
+		}
+		const size_t middle = begin + (end - begin) / 2;
+		const Node& node = nodes_[middle];
+		visit(middle, SquaredChord(node.position, target));
+		const double offset = target[node.axis] - node.position[node.axis];
+		const auto near = offset < 0 ? std::pair{ begin, middle } : std::pair{ middle + 1, end };
+		const auto far = offset < 0 ? std::pair{ middle + 1, end } : std::pair{ begin, middle };
+		VisitNearest(near.first, near.second, target, bound, visit);
+		if (offset * offset <= bound) {
+			VisitNearest(far.first, far.second, target, bound, visit);
+		}
+	}
+} // namespace geo
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "geo.h"
+
+namespace geo {
+	// Точка из индекса и расстояние до неё по формуле ComputeDistance
+	struct PointDistance {
+		uint32_t id = 0;
+		double distance = 0;
+	};
+
+	// k-d дерево над точками сферы. Точки хранятся единичными векторами в трёхмерном
+	// пространстве: длина хорды монотонна по расстоянию на сфере, поэтому отсечение
+	// по осям не ошибается ни у полюсов, ни на линии смены дат.
+	// Дерево неявное: узел - середина отрезка массива, построение за O(N log N)
+	class PointIndex {
+	public:
+		PointIndex() = default;
+		// Номер точки - её позиция в points
+		explicit PointIndex(const std::vector<Coordinates>& points);
+
+		size_t GetSize() const {
+			return nodes_.size();
+		}
+
+		// Точки не дальше radius метров, по возрастанию расстояния
+		std::vector<PointDistance> FindInRadius(Coordinates center, double radius) const;
+
+		// count ближайших точек по возрастанию расстояния
+		std::vector<PointDistance> FindNearest(Coordinates center, size_t count) const;
+
+	private:
+		struct Node {
+			double position[3];
+			Coordinates point;
+			uint32_t id;
+			uint8_t axis;
+		};
+
+		std::vector<Node> nodes_;
+
+		void Build(size_t begin, size_t end);
+		void CollectInRadius(size_t begin, size_t end, const double (&target)[3], double chord, std::vector<size_t>& result) const;
+		template <typename Visit>
+		void VisitNearest(size_t begin, size_t end, const double (&target)[3], double& bound, Visit& visit) const;
+	};
+} // namespace geo
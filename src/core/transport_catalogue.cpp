@@ -1,113 +1,326 @@
-#include "transport_catalogue.h"
-#include <unordered_set>
-#include <algorithm>
-#include <cassert>
-
-// Регистрирует новую остановку в системе
-bool TransportCatalogue::AddStop(BusStop stop) {
-	if (stop.empty()) {
-		return false;
-	}
-	stops_.push_back(std::move(stop));
-	ref_stops_.emplace(stops_.back().name, &stops_.back());
-	return true;
-}
-
-// Регистрирует новый маршрут в системе
-bool TransportCatalogue::AddRoute(Route route) {
-	if (route.empty()) {
-		return false;
-	}
-	routes_.push_back(std::move(route));
-	ref_routes_.emplace(routes_.back().name, &routes_.back());
-	return true;
-}
-
-// Предоставляет доступ к маршруту по имени
-const Route* TransportCatalogue::GetRoute(std::string_view name) const {
-	return ref_routes_.find(name) != ref_routes_.end() ? ref_routes_.at(name) : nullptr;
-}
-
-// Предоставляет доступ к остановке по имени
-const BusStop* TransportCatalogue::GetStop(std::string_view name) const {
-	return ref_stops_.find(name) != ref_stops_.end() ? ref_stops_.at(name) : nullptr;
-}
-
-// Сохраняет расстояние от from к to
-void TransportCatalogue::SetStopsDistance(const BusStopPair& p, size_t distance) {
-	assert(p.first && p.second); //Должны существовать обе остановки.
-
-	distance_to_neighbor_.emplace(p, distance);
-}
-
-// Возвращает расстояние от from к to
-std::optional<size_t> TransportCatalogue::GetStopsDistance(const BusStopPair& p, bool bidirectional) const {
-	if (p.first == nullptr || p.second == nullptr) {
-		return std::nullopt;
-	}
-
-	if (distance_to_neighbor_.contains(p)) {
-		return distance_to_neighbor_.at(p);
-	}
-
-	if (distance_to_neighbor_.contains({ p.second, p.first }) && bidirectional) {
-		return distance_to_neighbor_.at({ p.second, p.first });
-	}
-
-	return std::nullopt;
-}
-
-// Формирует статистику маршрута для отчетов
-std::optional<InfoRoute> TransportCatalogue::GetInfoRoute(std::string_view name) const {
-	const Route* route_ptr = GetRoute(name);
-	if (route_ptr == nullptr) {
-		return std::nullopt;
-	}
-
-	InfoRoute info;
-	std::unordered_set<const BusStop*> unique_stops{ route_ptr->driving_route.begin(), route_ptr->driving_route.end() };
-	info.name = route_ptr->name;
-	info.number_total = static_cast<int>(route_ptr->driving_route.size());
-	info.number_unique = static_cast<int>(unique_stops.size());
-
-	double lenght_shortest = 0;
-	for (auto i = 1; i < info.number_total; ++i) {
-		const BusStop* from = route_ptr->driving_route[i - 1];
-		const BusStop* to = route_ptr->driving_route[i];
-		lenght_shortest += ComputeDistance(from->geo_point, to->geo_point);
-	}
-
-	for (auto i = 1; i < info.number_total; ++i) {
-		const BusStop* from = route_ptr->driving_route[i - 1];
-		const BusStop* to = route_ptr->driving_route[i];
-		auto temp = GetStopsDistance({ from, to });
-		assert(temp.has_value());
-		info.route_length += static_cast<double>(temp.value());
-	}
-	info.curvature = info.route_length / lenght_shortest;
-
-	return info;
-}
-
-// Формирует список маршрутов через указанную остановку
-std::optional<InfoStop> TransportCatalogue::GetInfoStop(std::string_view name) const {
-	const BusStop* stop_ptr = GetStop(name);
-	if (stop_ptr == nullptr) {
-		return std::nullopt;
-	}
-
-	InfoStop info;
-	info.name = stop_ptr->name;
-	for (auto [name_route, route_ptr] : ref_routes_) {
-		auto it = std::ranges::find(route_ptr->driving_route, stop_ptr);
-		if (it != route_ptr->driving_route.end()) {
-			info.cross_references.push_back(name_route);
-		}
-	}
-	std::ranges::sort(info.cross_references);
-	return info;
-}
-
-const std::deque<Route>& TransportCatalogue::GetRoutes() const {
-	return routes_;
-}
+#include "transport_catalogue.h"
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+#include <utility>
+
+// Регистрирует новую остановку в системе
+bool TransportCatalogue::AddStop(BusStop stop) {
+	if (stop.empty()) {
+		return false;
+	}
+	stop.id = static_cast<StopId>(stops_.size());
+	stop.unit_vector = geo::ToUnitVector(stop.geo_point);
+	stops_.push_back(std::move(stop));
+	ref_stops_.emplace(stops_.back().name, &stops_.back());
+	stop_buses_.emplace_back();
+	return true;
+}
+
+// Регистрирует новый маршрут в системе
+bool TransportCatalogue::AddRoute(Route route) {
+	if (route.empty()) {
+		return false;
+	}
+	route.id = static_cast<RouteId>(routes_.size());
+	routes_.push_back(std::move(route));
+	route_stats_.emplace_back();
+	if (ref_routes_.emplace(routes_.back().name, &routes_.back()).second) {
+		IndexRouteStops(routes_.back());
+	}
+	return true;
+}
+
+// Удаляет маршрут из системы
+bool TransportCatalogue::RemoveRoute(std::string_view name) {
+	const auto it_ref = ref_routes_.find(name);
+	if (it_ref == ref_routes_.end()) {
+		return false;
+	}
+	Route& route = routes_[it_ref->second->id];
+	ref_routes_.erase(it_ref);
+	route_stats_[route.id].reset();
+	UnindexRouteStops(route);
+	route.name.clear();
+	route.driving_route.clear();
+	route.round_trip = false;
+	return true;
+}
+
+// Предоставляет доступ к маршруту по имени
+const Route* TransportCatalogue::GetRoute(std::string_view name) const {
+	return ref_routes_.find(name) != ref_routes_.end() ? ref_routes_.at(name) : nullptr;
+}
+
+// Предоставляет доступ к остановке по имени
+const BusStop* TransportCatalogue::GetStop(std::string_view name) const {
+	return ref_stops_.find(name) != ref_stops_.end() ? ref_stops_.at(name) : nullptr;
+}
+
+const BusStop& TransportCatalogue::GetStopById(StopId id) const {
+	return stops_[id];
+}
+
+const Route& TransportCatalogue::GetRouteById(RouteId id) const {
+	return routes_[id];
+}
+
+size_t TransportCatalogue::GetStopCount() const {
+	return stops_.size();
+}
+
+size_t TransportCatalogue::GetRouteCount() const {
+	return routes_.size();
+}
+
+// Сохраняет расстояние от from к to, если для пары его ещё нет
+void TransportCatalogue::SetStopsDistance(const BusStopPair& p, size_t distance) {
+	assert(p.first && p.second); //Должны существовать обе остановки.
+
+	if (FindFinalDistance(p.first->id, p.second->id) != nullptr
+		|| !pending_distances_.emplace(DistanceKey(p.first->id, p.second->id), distance).second) {
+		return;
+	}
+	ResetRouteStats(*p.first);
+}
+
+// Сохраняет расстояние от from к to, заменяя сохранённое ранее
+void TransportCatalogue::UpdateStopsDistance(const BusStopPair& p, size_t distance) {
+	assert(p.first && p.second); //Должны существовать обе остановки.
+
+	// Известная паре ячейка обновляется на месте, новая пара ждёт следующего Finalize
+	if (size_t* stored = FindFinalDistance(p.first->id, p.second->id)) {
+		*stored = distance;
+	} else {
+		pending_distances_.insert_or_assign(DistanceKey(p.first->id, p.second->id), distance);
+	}
+	ResetRouteStats(*p.first);
+}
+
+// Расстояние входит в длину только маршрутов, проходящих через обе остановки
+void TransportCatalogue::ResetRouteStats(const BusStop& stop) {
+	for (std::string_view name : stop_buses_[stop.id]) {
+		route_stats_[ref_routes_.at(name)->id].reset();
+	}
+}
+
+uint64_t TransportCatalogue::DistanceKey(StopId from, StopId to) {
+	return (static_cast<uint64_t>(from) << 32) | to;
+}
+
+// Переносит расстояния в CSR: для каждой остановки from отрезок distance_neighbors_
+// [distance_offsets_[from], distance_offsets_[from + 1]), упорядоченный по StopId соседа
+void TransportCatalogue::BuildDistanceIndex() {
+	if (pending_distances_.empty() && distance_offsets_.size() == stops_.size() + 1) {
+		return;
+	}
+	std::vector<std::pair<StopId, Neighbor>> entries;
+	entries.reserve(distance_neighbors_.size() + pending_distances_.size());
+	for (StopId from = 0; from + 1 < distance_offsets_.size(); ++from) {
+		for (uint32_t i = distance_offsets_[from]; i < distance_offsets_[from + 1]; ++i) {
+			entries.emplace_back(from, distance_neighbors_[i]);
+		}
+	}
+	for (const auto& [key, distance] : pending_distances_) {
+		entries.emplace_back(static_cast<StopId>(key >> 32), Neighbor{ static_cast<StopId>(key), distance });
+	}
+	std::ranges::sort(entries, {}, [](const auto& entry) { return std::pair{ entry.first, entry.second.stop }; });
+
+	distance_offsets_.assign(stops_.size() + 1, 0);
+	distance_neighbors_.clear();
+	distance_neighbors_.reserve(entries.size());
+	for (const auto& [from, neighbor] : entries) {
+		++distance_offsets_[from + 1];
+		distance_neighbors_.push_back(neighbor);
+	}
+	for (size_t from = 0; from < stops_.size(); ++from) {
+		distance_offsets_[from + 1] += distance_offsets_[from];
+	}
+	pending_distances_.clear();
+}
+
+// Двоичный поиск в отрезке from, степень остановки обычно мала
+size_t* TransportCatalogue::FindFinalDistance(StopId from, StopId to) {
+	return const_cast<size_t*>(std::as_const(*this).FindFinalDistance(from, to));
+}
+
+const size_t* TransportCatalogue::FindFinalDistance(StopId from, StopId to) const {
+	if (size_t{ from } + 1 >= distance_offsets_.size()) {
+		return nullptr;
+	}
+	const auto first = distance_neighbors_.begin() + distance_offsets_[from];
+	const auto last = distance_neighbors_.begin() + distance_offsets_[from + 1];
+	const auto it = std::ranges::lower_bound(first, last, to, {}, &Neighbor::stop);
+	return it != last && it->stop == to ? &it->distance : nullptr;
+}
+
+std::optional<size_t> TransportCatalogue::FindDistance(StopId from, StopId to) const {
+	if (const size_t* distance = FindFinalDistance(from, to)) {
+		return *distance;
+	}
+	if (pending_distances_.empty()) {
+		return std::nullopt;
+	}
+	if (const auto it = pending_distances_.find(DistanceKey(from, to)); it != pending_distances_.end()) {
+		return it->second;
+	}
+	return std::nullopt;
+}
+
+// Строит индексы расстояний и координат и вычисляет статистику маршрутов, для которых её ещё нет
+void TransportCatalogue::Finalize() {
+	BuildDistanceIndex();
+	if (stop_index_.GetSize() != stops_.size()) {
+		std::vector<geo::Coordinates> points;
+		points.reserve(stops_.size());
+		for (const BusStop& stop : stops_) {
+			points.push_back(stop.geo_point);
+		}
+		stop_index_ = geo::PointIndex(points);
+	}
+	// Маршрут без расстояния между соседними остановками остаётся без статистики:
+	// загрузка не прерывается, ошибкой становится только запрос этого маршрута
+	for (const auto& [name, route_ptr] : ref_routes_) {
+		if (!route_stats_[route_ptr->id]) {
+			route_stats_[route_ptr->id] = ComputeInfoRoute(*route_ptr);
+		}
+	}
+}
+
+// Возвращает расстояние от from к to
+std::optional<size_t> TransportCatalogue::GetStopsDistance(const BusStopPair& p, bool bidirectional) const {
+	if (p.first == nullptr || p.second == nullptr) {
+		return std::nullopt;
+	}
+	return GetStopsDistance(p.first->id, p.second->id, bidirectional);
+}
+
+std::optional<size_t> TransportCatalogue::GetStopsDistance(StopId from, StopId to, bool bidirectional) const {
+	if (auto distance = FindDistance(from, to)) {
+		return distance;
+	}
+	if (!bidirectional) {
+		return std::nullopt;
+	}
+	return FindDistance(to, from);
+}
+
+// Формирует статистику маршрута для отчетов
+std::optional<InfoRoute> TransportCatalogue::GetInfoRoute(std::string_view name) const {
+	const Route* route_ptr = GetRoute(name);
+	if (route_ptr == nullptr) {
+		return std::nullopt;
+	}
+	if (route_stats_[route_ptr->id]) {
+		return route_stats_[route_ptr->id];
+	}
+	if (auto info = ComputeInfoRoute(*route_ptr)) {
+		return info;
+	}
+	throw std::out_of_range("No road distance between stops of bus " + route_ptr->name);
+}
+
+std::optional<InfoRoute> TransportCatalogue::ComputeInfoRoute(const Route& route) const {
+	InfoRoute info;
+	std::vector<StopId> unique_stops;
+	for (const BusStop* stop : route.driving_route) {
+		unique_stops.push_back(stop->id);
+	}
+	std::ranges::sort(unique_stops);
+	unique_stops.erase(std::unique(unique_stops.begin(), unique_stops.end()), unique_stops.end());
+	info.name = route.name;
+	info.number_total = static_cast<int>(route.driving_route.size());
+	info.number_unique = static_cast<int>(unique_stops.size());
+
+	std::vector<geo::UnitVector> points;
+	points.reserve(route.driving_route.size());
+	for (const BusStop* stop : route.driving_route) {
+		points.push_back(stop->unit_vector);
+	}
+	const double lenght_shortest = geo::ComputeLength(points);
+
+	for (auto i = 1; i < info.number_total; ++i) {
+		const BusStop* from = route.driving_route[i - 1];
+		const BusStop* to = route.driving_route[i];
+		const auto distance = GetStopsDistance({ from, to });
+		if (!distance) {
+			return std::nullopt;
+		}
+		info.route_length += static_cast<double>(*distance);
+	}
+	info.curvature = info.route_length / lenght_shortest;
+
+	return info;
+}
+
+// Формирует список маршрутов через указанную остановку
+std::optional<InfoStop> TransportCatalogue::GetInfoStop(std::string_view name) const {
+	const BusStop* stop_ptr = GetStop(name);
+	if (stop_ptr == nullptr) {
+		return std::nullopt;
+	}
+
+	InfoStop info;
+	info.name = stop_ptr->name;
+	info.cross_references = stop_buses_[stop_ptr->id];
+	return info;
+}
+
+std::vector<StopDistance> TransportCatalogue::FindStopsInRadius(geo::Coordinates center, double radius) const {
+	std::vector<StopDistance> result;
+	for (const geo::PointDistance& point : stop_index_.FindInRadius(center, radius)) {
+		result.push_back({ &stops_[point.id], point.distance });
+	}
+	if (stop_index_.GetSize() == stops_.size()) {
+		return result;
+	}
+	for (size_t id = stop_index_.GetSize(); id < stops_.size(); ++id) {
+		if (const double distance = ComputeDistance(center, stops_[id].geo_point); distance <= radius) {
+			result.push_back({ &stops_[id], distance });
+		}
+	}
+	std::ranges::sort(result, {}, [](const StopDistance& item) { return std::pair{ item.distance, item.stop->id }; });
+	return result;
+}
+
+std::vector<StopDistance> TransportCatalogue::FindNearestStops(geo::Coordinates center, size_t count) const {
+	std::vector<StopDistance> result;
+	for (const geo::PointDistance& point : stop_index_.FindNearest(center, count)) {
+		result.push_back({ &stops_[point.id], point.distance });
+	}
+	if (stop_index_.GetSize() == stops_.size()) {
+		return result;
+	}
+	for (size_t id = stop_index_.GetSize(); id < stops_.size(); ++id) {
+		result.push_back({ &stops_[id], ComputeDistance(center, stops_[id].geo_point) });
+	}
+	std::ranges::sort(result, {}, [](const StopDistance& item) { return std::pair{ item.distance, item.stop->id }; });
+	result.resize(std::min(result.size(), count));
+	return result;
+}
+
+const std::deque<Route>& TransportCatalogue::GetRoutes() const {
+	return routes_;
+}
+
+// Добавляет имя маршрута в упорядоченные списки его остановок, повторная остановка
+// маршрута (кольцо, обратный ход) в списке не дублируется
+void TransportCatalogue::IndexRouteStops(const Route& route) {
+	for (const BusStop* stop : route.driving_route) {
+		std::vector<std::string_view>& buses = stop_buses_[stop->id];
+		const auto it = std::ranges::lower_bound(buses, std::string_view{ route.name });
+		if (it == buses.end() || *it != route.name) {
+			buses.insert(it, route.name);
+		}
+	}
+}
+
+void TransportCatalogue::UnindexRouteStops(const Route& route) {
+	for (const BusStop* stop : route.driving_route) {
+		std::vector<std::string_view>& buses = stop_buses_[stop->id];
+		const auto it = std::ranges::lower_bound(buses, std::string_view{ route.name });
+		if (it != buses.end() && *it == route.name) {
+			buses.erase(it);
+		}
+	}
+}
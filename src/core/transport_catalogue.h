@@ -1,58 +1,110 @@
-#pragma once
-
-#include<string>
-#include<string_view>
-#include<deque>
-#include<vector>
-#include<unordered_map>
-#include<optional>
-#include<utility>
-#include<cstddef>
-
-#include "domain.h"
-
-// Обеспечивает хранение и поиск данных транспортной сети
-class TransportCatalogue {
-	struct BusStopPairHasher {
-		static constexpr size_t HASH_PRIME = 37;
-		size_t operator()(const BusStopPair& p) const {
-			return hasher(p.first) + hasher(p.second) * HASH_PRIME;
-		}
-		inline static std::hash<const BusStop*> hasher{};
-	};
-
-public:
-	// Регистрирует новую остановку в системе
-	bool AddStop(BusStop stop);
-
-	// Регистрирует новый маршрут в системе
-	bool AddRoute(Route route);
-
-	// Предоставляет доступ к маршруту по имени
-	[[nodiscard]] const Route* GetRoute(std::string_view name) const;
-
-	// Предоставляет доступ к остановке по имени
-	[[nodiscard]] const BusStop* GetStop(std::string_view name) const;
-
-	// Сохраняет расстояние от from к to
-	void SetStopsDistance(const BusStopPair& p, size_t distance);
-
-	// Возвращает расстояние от from к to
-	[[nodiscard]] std::optional<size_t> GetStopsDistance(const BusStopPair& p, bool bidirectional = true) const;
-
-	// Формирует статистику маршрута для отчетов
-	[[nodiscard]] std::optional<InfoRoute> GetInfoRoute(std::string_view name) const;
-
-	// Формирует список маршрутов через указанную остановку
-	[[nodiscard]] std::optional<InfoStop> GetInfoStop(std::string_view name) const;
-
-	// Предоставляет информацию о существующих маршрутах
-	[[nodiscard]] const std::deque<Route>& GetRoutes() const;
-
-private:
-	std::deque<BusStop> stops_;
-	std::deque<Route> routes_;
-	std::unordered_map<std::string_view, const BusStop*> ref_stops_;
-	std::unordered_map<std::string_view, const Route*> ref_routes_;
-	std::unordered_map<BusStopPair, size_t, BusStopPairHasher> distance_to_neighbor_;
+#pragma once
+
+#include<string>
+#include<string_view>
+#include<deque>
+#include<vector>
+#include<unordered_map>
+#include<optional>
+#include<utility>
+#include<cstddef>
+#include<cstdint>
+
+#include "domain.h"
+#include "point_index.h"
+
+// Обеспечивает хранение и поиск данных транспортной сети
+class TransportCatalogue {
+public:
+	// Регистрирует новую остановку в системе и назначает ей следующий StopId
+	bool AddStop(BusStop stop);
+
+	// Регистрирует новый маршрут в системе и назначает ему следующий RouteId
+	bool AddRoute(Route route);
+
+	// Удаляет маршрут из системы. Запись маршрута остаётся пустой, чтобы не сдвигать
+	// указатели и порядок остальных маршрутов
+	bool RemoveRoute(std::string_view name);
+
+	// Предоставляет доступ к маршруту по имени
+	[[nodiscard]] const Route* GetRoute(std::string_view name) const;
+
+	// Предоставляет доступ к остановке по имени
+	[[nodiscard]] const BusStop* GetStop(std::string_view name) const;
+
+	// Предоставляет доступ к остановке и маршруту по номеру, номер должен существовать
+	[[nodiscard]] const BusStop& GetStopById(StopId id) const;
+	[[nodiscard]] const Route& GetRouteById(RouteId id) const;
+
+	// Число выданных номеров: StopId и RouteId лежат в [0, count). Удалённые маршруты
+	// сохраняют номер
+	[[nodiscard]] size_t GetStopCount() const;
+	[[nodiscard]] size_t GetRouteCount() const;
+
+	// Сохраняет расстояние от from к to. Уже сохранённое расстояние пары не меняется:
+	// при повторах во входных данных действует первое значение
+	void SetStopsDistance(const BusStopPair& p, size_t distance);
+
+	// Сохраняет расстояние от from к to, заменяя сохранённое ранее. Для изменения каталога
+	// после загрузки; статистика маршрутов через from сбрасывается до следующего Finalize
+	void UpdateStopsDistance(const BusStopPair& p, size_t distance);
+
+	// Завершает загрузку: упаковывает расстояния в массив соседей каждой остановки,
+	// строит пространственный индекс остановок и вычисляет статистику маршрутов, у которых её нет.
+	// Вызывается после задания расстояний и повторно после изменений каталога
+	void Finalize();
+
+	// Возвращает расстояние от from к to
+	[[nodiscard]] std::optional<size_t> GetStopsDistance(const BusStopPair& p, bool bidirectional = true) const;
+	[[nodiscard]] std::optional<size_t> GetStopsDistance(StopId from, StopId to, bool bidirectional = true) const;
+
+	// Формирует статистику маршрута для отчетов: после Finalize - готовая запись,
+	// до него или после изменения маршрута - расчёт по остановкам. Если между соседними
+	// остановками маршрута нет расстояния, выбрасывает std::out_of_range
+	[[nodiscard]] std::optional<InfoRoute> GetInfoRoute(std::string_view name) const;
+
+	// Формирует список маршрутов через указанную остановку за время, пропорциональное его длине
+	[[nodiscard]] std::optional<InfoStop> GetInfoStop(std::string_view name) const;
+
+	// Остановки не дальше radius метров от center по возрастанию расстояния
+	[[nodiscard]] std::vector<StopDistance> FindStopsInRadius(geo::Coordinates center, double radius) const;
+
+	// count ближайших к center остановок по возрастанию расстояния
+	[[nodiscard]] std::vector<StopDistance> FindNearestStops(geo::Coordinates center, size_t count) const;
+
+	// Предоставляет информацию о существующих маршрутах
+	[[nodiscard]] const std::deque<Route>& GetRoutes() const;
+
+private:
+	std::deque<BusStop> stops_;
+	std::deque<Route> routes_;
+	std::unordered_map<std::string_view, const BusStop*> ref_stops_;
+	std::unordered_map<std::string_view, const Route*> ref_routes_;
+	// Упорядоченные имена маршрутов через каждую остановку, индекс - StopId
+	std::vector<std::vector<std::string_view>> stop_buses_;
+	// Расстояния после Finalize: соседи каждой остановки подряд, упорядочены по StopId
+	struct Neighbor {
+		StopId stop;
+		size_t distance;
+	};
+	std::vector<uint32_t> distance_offsets_;
+	std::vector<Neighbor> distance_neighbors_;
+	// Расстояния новых пар до следующего Finalize, ключ - пара StopId {from, to} в одном числе
+	std::unordered_map<uint64_t, size_t> pending_distances_;
+	// Статистика маршрутов, вычисленная в Finalize, индекс - RouteId
+	std::vector<std::optional<InfoRoute>> route_stats_;
+	// k-d дерево координат остановок с номерами [0, stop_index_.GetSize()), построенное
+	// в Finalize. Остановки, добавленные позже, просматриваются перебором
+	geo::PointIndex stop_index_;
+
+	static uint64_t DistanceKey(StopId from, StopId to);
+	void BuildDistanceIndex();
+	size_t* FindFinalDistance(StopId from, StopId to);
+	const size_t* FindFinalDistance(StopId from, StopId to) const;
+	std::optional<size_t> FindDistance(StopId from, StopId to) const;
+	// nullopt, если между какими-то соседними остановками маршрута нет расстояния
+	std::optional<InfoRoute> ComputeInfoRoute(const Route& route) const;
+	void ResetRouteStats(const BusStop& stop);
+	void IndexRouteStops(const Route& route);
+	void UnindexRouteStops(const Route& route);
 };
\ No newline at end of file
@@ -1,451 +1,928 @@
-#include "json.h"
-
-#include <string_view>
-#include <algorithm>
-#include <sstream>
-
-using namespace std;
-
-namespace json {
-
-	namespace detail {
-
-		Node LoadNode(std::string_view input);
-		std::string StringParsing(std::string_view str);
-		std::string StringSerialization(const std::string& str);
-
-		using Iterator = std::string_view::iterator;
-
-		std::pair<std::string_view, Node> ParsePair(std::string_view input) {
-			auto key_start = std::ranges::find(input, '\"');
-			auto key_end = std::find(++key_start, input.end(), '\"');
-			auto value_start = std::find(key_end, input.end(), ':') + 1;
-
-			std::string_view key(&(*key_start), key_end - key_start);
-			std::string_view value(&(*value_start), input.end() - value_start);
-
-			return std::make_pair(key, LoadNode(value));
-		}
-
-		Iterator FindMatchingBracket(std::string_view input, Iterator start, char op_bracket, char cl_bracket) {
-			int count = 1;
-			auto it = start + 1;
-			while (count > 0 && it != input.end()) {
-				count += *it == op_bracket ? 1 : *it == cl_bracket ? -1 : 0;
-				++it;
-			}
-			if (count != 0) {
-				throw ParsingError("Unmatched bracket");
-			}
-			return it;
-		}
-
-		Iterator FindValueEnd(std::string_view input, Iterator start) {
-			auto comma_pos = std::find(start, input.end(), ',');
-			auto braсket_op = std::find_if(start, comma_pos, [](const auto& c) {return c == '[' || c == '{'; });
-			if (braсket_op != comma_pos) {
-				char cl_bracker = *braсket_op == '{' ? '}' : ']';
-				return FindMatchingBracket(input, braсket_op, *braсket_op, cl_bracker);
-			}
-			return comma_pos;
-		}
-
-		Node LoadArray(std::string_view input) {
-			Array result;
-
-			auto start_pos = input.begin();
-			while (true) {
-				start_pos = std::find_if(start_pos, input.end(), [](const auto& c) {return c != ' ' && c != ','; });
-				if (start_pos == input.end()) {
-					break;
-				}
-
-				if (*start_pos == '{' || *start_pos == '[') {
-					char cl_bracker = *start_pos == '{' ? '}' : ']';
-					auto it = FindMatchingBracket(input, start_pos, *start_pos, cl_bracker);
-					result.emplace_back(LoadNode({ start_pos, it }));
-					start_pos = it == input.end() ? input.end() : ++it;
-					continue;
-				}
-
-				auto comma_pos = std::find(start_pos, input.end(), ',');
-				auto end_pos = comma_pos;
-
-				std::string_view sub_str(&(*start_pos), end_pos - start_pos);
-				result.emplace_back(LoadNode(sub_str));
-				start_pos = end_pos;
-			}
-			return Node{ result };
-		}
-
-		Node LoadMap(std::string_view input) {
-			Dict result;
-			auto start_pos = input.begin();
-			while (true) {
-				start_pos = std::find_if(start_pos, input.end(), [](const auto& c) {return c != ' ' && c != ','; });
-				if (start_pos == input.end()) {
-					break;
-				}
-
-				if (*start_pos == '{' || *start_pos == '[') {
-					char cl_bracker = *start_pos == '{' ? '}' : ']';
-					auto it = FindMatchingBracket(input, start_pos, *start_pos, cl_bracker);
-					result.emplace(ParsePair({ start_pos, it }));
-					start_pos = it == input.end() ? input.end() : ++it;
-					continue;
-				}
-
-				auto colon = std::find(start_pos, input.end(), ':');
-				auto end_pos = FindValueEnd(input, next(colon));
-
-				std::string_view sub_str(&(*start_pos), end_pos - start_pos);
-				result.emplace(ParsePair(sub_str));
-				start_pos = end_pos;
-			}
-			return Node{ result };
-		}
-
-		Node LoadString(std::string_view input) {
-			return Node{ detail::StringParsing(input) };
-		}
-
-		Node LoadNumber(std::string_view input) {
-
-			auto invalid_symbol = [](char c) {return !std::isdigit(c) && (c != '.' && c != '+' && c != '-' && c != 'e' && c != 'E'); };
-			if (std::ranges::find_if(input, invalid_symbol) != input.end()) {
-				throw(ParsingError("Invalid Number"));
-			}
-
-			std::string str{ input };
-
-			double num_d = std::stod(str);
-			int num_i = static_cast<int>(num_d);
-
-			auto is_double = [](char c) {return c == '.' || c == 'e' || c == 'E'; };
-
-			if (std::ranges::find_if(str, is_double) != str.end()) {
-				return Node{ num_d };
-			}
-
-			return Node{ num_i };
-		}
-
-		Node LoadPrimitive(std::string_view input) {
-			auto predicate = [](char c) {return c == ']' || c == '}'; };
-			if (std::ranges::find_if(input, predicate) != input.end()) {
-				throw(ParsingError("Invalid Primitive"));
-			}
-
-			if (input == "null") {
-				return Node{ nullptr };
-			}
-
-			if (input == "true" || input == "false") {
-				return input == "true" ? Node{ true } : Node{ false };
-			}
-
-			return LoadNumber(input);
-		}
-
-		Node LoadNode(std::string_view input) {
-			if (input.empty()) {
-				return {};
-			}
-
-			auto predicate = [](char c) {return c != '\n' && c != '\r' && c != '\t' && c != ' '; };
-			auto it_first_symbol = std::find_if(input.begin(), input.end(), predicate);
-			auto it_last_symbol = input.end();
-			if (*it_first_symbol == '{') {
-				auto rfound = std::find(input.rbegin(), input.rend(), '}');
-				if (rfound == input.rend()) {
-					throw(ParsingError("Invalid Dict"));
-				}
-				auto offset = std::distance(rfound, input.rbegin());
-				it_last_symbol = it_last_symbol + offset;
-				return LoadMap({ ++it_first_symbol, --it_last_symbol });
-			}
-
-			if (*it_first_symbol == '[') {
-				auto rfound = std::find(input.rbegin(), input.rend(), ']');
-				if (rfound == input.rend()) {
-					throw(ParsingError("Invalid Array"));
-				}
-				auto offset = std::distance(rfound, input.rbegin());
-				it_last_symbol = it_last_symbol + offset;
-				return LoadArray({ ++it_first_symbol, --it_last_symbol });
-			}
-
-			if (*it_first_symbol == '\"') {
-				auto rfound = std::find(input.rbegin(), input.rend(), '\"');
-				auto offset = std::distance(rfound, input.rbegin());
-				it_last_symbol = it_last_symbol + offset;
-				if (++it_first_symbol > --it_last_symbol) {
-					throw(ParsingError("Invalid String"));
-				}
-				return LoadString({ it_first_symbol, it_last_symbol });
-			}
-
-			auto offset = std::distance(std::find_if(input.rbegin(), input.rend(), predicate), input.rbegin());
-			it_last_symbol = it_last_symbol + offset;
-
-			return LoadPrimitive({ it_first_symbol, it_last_symbol });
-		}
-
-		std::string StringParsing(std::string_view input) {
-			std::string str;
-			for (auto it = input.begin(); it != input.end(); ++it) {
-				if (*it == '\\' && std::next(it) != input.end()) {
-					switch (*++it) {
-					case 'r':  str += '\r'; break;
-					case 'n':  str += '\n'; break;
-					case 't':  str += '\t'; break;
-					case '"':  str += '\"'; break;
-					case '\\': str += '\\'; break;
-					default:   str += '\\'; str += *it;  // недопустимый escape
-					}
-				} else {
-					str += *it;
-				}
-			}
-			return str;
-		}
-
-		std::string StringSerialization(const std::string& str) {
-			std::string result;
-			for (char c : str) {
-				switch (c) {
-				case '\r': result += "\\r"; break;
-				case '\n': result += "\\n"; break;
-				case '\t': result += "\\t"; break;
-				case '\"': result += "\\\""; break;
-				case '\\': result += "\\\\"; break;
-				default:   result += c;
-				}
-			}
-			return "\"" + result + "\"";
-		}
-
-		std::string MakeIndent(int level) {
-			static const int indent = 4;
-			return std::string(level * indent, ' ');
-		}
-
-		void PrintArray(const Node& node, std::ostream& output, int level = 0) {
-			const Array& arr = node.AsArray();
-			if (arr.empty()) {
-				output << "[]";
-				return;
-			}
-
-			output << "[\n";
-			for (auto it = arr.begin(); it != arr.end(); ++it) {
-				output << MakeIndent(level + 1);
-				PrintNode(*it, output, level + 1);
-				output << (it == std::prev(arr.end()) ? "\n" : ",\n");
-			}
-			output << MakeIndent(level) << "]";
-		}
-
-		void PrintMap(const Node& node, std::ostream& output, int level = 0) {
-			const Dict& map = node.AsMap();
-			if (map.empty()) {
-				output << "{}";
-				return;
-			}
-
-			output << "{\n";
-			for (auto it = map.begin(); it != map.end(); ++it) {
-				auto [key, value] = *it;
-				output << MakeIndent(level + 1) << "\"" << key << "\": ";
-				PrintNode(value, output, level + 1);
-				output << (it == std::prev(map.end()) ? "\n" : ",\n");
-			}
-			output << MakeIndent(level) << "}";
-		}
-
-	}  // namespace detail
-
-	//-----Node-----
-
-	bool Node::IsNull() const {
-		return std::holds_alternative<std::nullptr_t>(*this);
-	}
-
-	bool Node::IsBool() const {
-		return std::holds_alternative<bool>(*this);
-	}
-
-	bool Node::IsInt() const {
-		return std::holds_alternative<int>(*this);
-	}
-
-	bool Node::IsDouble() const {
-		return IsPureDouble() || IsInt();
-	}
-
-	bool Node::IsPureDouble() const {
-		return std::holds_alternative<double>(*this);
-	}
-
-	bool Node::IsString() const {
-		return std::holds_alternative<std::string>(*this);
-	}
-
-	bool Node::IsArray() const {
-		return std::holds_alternative<json::Array>(*this);
-	}
-
-	bool Node::IsMap() const {
-		return std::holds_alternative<json::Dict>(*this);
-	}
-
-	bool Node::AsBool() const {
-		if (!IsBool()) {
-			throw(std::logic_error("Invalid Bool"));
-		}
-		return get<bool>(*this);
-	}
-
-	int Node::AsInt() const {
-		if (!IsInt()) {
-			throw(std::logic_error("Invalid Int"));
-		}
-		return get<int>(*this);
-	}
-
-	double Node::AsDouble() const {
-		if (!IsDouble()) {
-			throw(std::logic_error("Invalid Double"));
-		}
-		return IsPureDouble() ? get<double>(*this) : static_cast<double>(AsInt());
-	}
-
-	const string& Node::AsString() const {
-		if (!IsString()) {
-			throw(std::logic_error("Invalid String"));
-		}
-		return get<std::string>(*this);
-	}
-
-	const Array& Node::AsArray() const {
-		return const_cast<Node*>(this)->AsArray();
-	}
-
-	const Dict& Node::AsMap() const {
-		return const_cast<Node*>(this)->AsMap();
-	}
-
-	Array& Node::AsArray() {
-		if (!IsArray()) {
-			throw(std::logic_error("Invalid Array"));
-		}
-		return get<Array>(*this);
-	}
-
-	Dict& Node::AsMap() {
-		if (!IsMap()) {
-			throw(std::logic_error("Invalid Map"));
-		}
-		return get<Dict>(*this);
-	}
-
-
-	bool operator==(const Node& lhs, const Node& rhs) {
-		if (lhs.IsNull() && rhs.IsNull()) {
-			return true;
-		}
-
-		if (lhs.IsBool() && rhs.IsBool()) {
-			return lhs.AsBool() == rhs.AsBool();
-		}
-
-		if (lhs.IsInt() && rhs.IsInt()) {
-			return lhs.AsInt() == rhs.AsInt();
-		}
-
-		if (lhs.IsPureDouble() && rhs.IsPureDouble()) {
-			return lhs.AsDouble() == rhs.AsDouble();
-		}
-
-		if (lhs.IsString() && rhs.IsString()) {
-			return lhs.AsString() == rhs.AsString();
-		}
-
-		if (lhs.IsArray() && rhs.IsArray()) {
-			return lhs.AsArray() == rhs.AsArray();
-		}
-
-		if (lhs.IsMap() && rhs.IsMap()) {
-			return lhs.AsMap() == rhs.AsMap();
-		}
-
-		return false;
-	}
-
-	Node LoadNode(istream& input) {
-		std::string str;
-		while (input.good()) {
-			std::string temp;
-			std::getline(input, temp);
-			str += temp;
-		}
-		return detail::LoadNode(str);
-	}
-
-	//-----Document-----
-
-	Document::Document(Node root)
-		: root_(std::move(root)) {
-	}
-
-	const Node& Document::GetRoot() const {
-		return root_;
-	}
-
-	Document Load(istream& input) {
-		return Document{ LoadNode(input) };
-	}
-
-	bool operator==(const Document& lhs, const Document& rhs) {
-		return lhs.GetRoot() == rhs.GetRoot();
-	}
-
-	void Print(const Document& doc, std::ostream& output) {
-		PrintNode(doc.GetRoot(), output);
-	}
-
-	void PrintNode(const Node& node, std::ostream& output, int level) {
-		if (node.IsNull()) {
-			output << "null";
-			return;
-		}
-
-		if (node.IsBool()) {
-			output << (node.AsBool() ? "true" : "false");
-			return;
-		}
-
-		if (node.IsInt()) {
-			output << node.AsInt();
-			return;
-		}
-
-		if (node.IsPureDouble()) {
-			output << node.AsDouble();
-			return;
-		}
-
-		if (node.IsString()) {
-			output << detail::StringSerialization(node.AsString());
-			return;
-		}
-
-		if (node.IsArray()) {
-			detail::PrintArray(node, output, level);
-		}
-
-		if (node.IsMap()) {
-			detail::PrintMap(node, output, level);
-		}
-	}
+#include "json.h"
+
+#include <string_view>
+#include <algorithm>
+#include <bit>
+#include <cctype>
+#include <charconv>
+#include <iterator>
+#include <cstdint>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#define JSON_HAS_SSE2 1
+#if defined(__GNUC__) || defined(__clang__)
+#define JSON_HAS_AVX2 1
+#endif
+#endif
+
+using namespace std;
+
+namespace json {
+
+	namespace detail {
+
+		std::string StringSerialization(std::string_view str);
+
+		// Маски 64 байт входа: бит i отмечает байт i
+		struct ChunkMasks {
+			// Любой символ, кроме пробела, \t, \n и \r
+			uint64_t non_space = 0;
+			// Кавычка или обратная косая черта - символы, на которых прерывается строка
+			uint64_t string_stop = 0;
+		};
+
+		constexpr size_t CHUNK_SIZE = 64;
+
+		ChunkMasks ClassifyChunkScalar(const char* data) {
+			ChunkMasks masks;
+			for (size_t i = 0; i < CHUNK_SIZE; ++i) {
+				const char c = data[i];
+				const uint64_t bit = uint64_t{ 1 } << i;
+				masks.non_space |= (c != ' ' && c != '\n' && c != '\r' && c != '\t') ? bit : 0;
+				masks.string_stop |= (c == '\"' || c == '\\') ? bit : 0;
+			}
+			return masks;
+		}
+
+		// Неполный последний фрагмент дополняется пробелами: они не отмечены ни в одной маске
+		template <typename Classify>
+		void IndexTail(const char* data, size_t size, ChunkMasks* masks, Classify classify) {
+			if (size % CHUNK_SIZE != 0) {
+				char chunk[CHUNK_SIZE];
+				std::fill(std::copy(data + size / CHUNK_SIZE * CHUNK_SIZE, data + size, chunk), chunk + CHUNK_SIZE, ' ');
+				masks[size / CHUNK_SIZE] = classify(chunk);
+			}
+		}
+
+		void IndexScalar(const char* data, size_t size, ChunkMasks* masks) {
+			for (size_t chunk = 0; chunk < size / CHUNK_SIZE; ++chunk) {
+				masks[chunk] = ClassifyChunkScalar(data + chunk * CHUNK_SIZE);
+			}
+			IndexTail(data, size, masks, ClassifyChunkScalar);
+		}
+
+#ifdef JSON_HAS_SSE2
+		ChunkMasks ClassifyChunkSse2(const char* data) {
+			ChunkMasks masks;
+			for (size_t part = 0; part < CHUNK_SIZE / 16; ++part) {
+				const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + part * 16));
+				const __m128i space = _mm_or_si128(
+					_mm_or_si128(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(bytes, _mm_set1_epi8('\n'))),
+					_mm_or_si128(_mm_cmpeq_epi8(bytes, _mm_set1_epi8('\r')), _mm_cmpeq_epi8(bytes, _mm_set1_epi8('\t'))));
+				const __m128i stop = _mm_or_si128(_mm_cmpeq_epi8(bytes, _mm_set1_epi8('\"')), _mm_cmpeq_epi8(bytes, _mm_set1_epi8('\\')));
+				masks.non_space |= uint64_t{ static_cast<uint16_t>(~_mm_movemask_epi8(space)) } << (part * 16);
+				masks.string_stop |= uint64_t{ static_cast<uint16_t>(_mm_movemask_epi8(stop)) } << (part * 16);
+			}
+			return masks;
+		}
+
+		void IndexSse2(const char* data, size_t size, ChunkMasks* masks) {
+			for (size_t chunk = 0; chunk < size / CHUNK_SIZE; ++chunk) {
+				masks[chunk] = ClassifyChunkSse2(data + chunk * CHUNK_SIZE);
+			}
+			IndexTail(data, size, masks, ClassifyChunkSse2);
+		}
+#endif
+
+#ifdef JSON_HAS_AVX2
+		__attribute__((target("avx2"))) ChunkMasks ClassifyChunkAvx2(const char* data) {
+			ChunkMasks masks;
+			for (size_t part = 0; part < CHUNK_SIZE / 32; ++part) {
+				const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + part * 32));
+				const __m256i space = _mm256_or_si256(
+					_mm256_or_si256(_mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(' ')), _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('\n'))),
+					_mm256_or_si256(_mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('\r')), _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('\t'))));
+				const __m256i stop = _mm256_or_si256(_mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('\"')), _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('\\')));
+				masks.non_space |= uint64_t{ ~static_cast<uint32_t>(_mm256_movemask_epi8(space)) } << (part * 32);
+				masks.string_stop |= uint64_t{ static_cast<uint32_t>(_mm256_movemask_epi8(stop)) } << (part * 32);
+			}
+			return masks;
+		}
+
+		__attribute__((target("avx2"))) void IndexAvx2(const char* data, size_t size, ChunkMasks* masks) {
+			for (size_t chunk = 0; chunk < size / CHUNK_SIZE; ++chunk) {
+				masks[chunk] = ClassifyChunkAvx2(data + chunk * CHUNK_SIZE);
+			}
+			IndexTail(data, size, masks, ClassifyChunkAvx2);
+		}
+#endif
+
+		using IndexFunction = void (*)(const char* data, size_t size, ChunkMasks* masks);
+
+		// Реализация выбирается один раз по возможностям процессора, на котором запущена программа
+		IndexFunction SelectIndexFunction() {
+#ifdef JSON_HAS_AVX2
+			if (__builtin_cpu_supports("avx2")) {
+				return IndexAvx2;
+			}
+#endif
+#ifdef JSON_HAS_SSE2
+			return IndexSse2;
+#else
+			return IndexScalar;
+#endif
+		}
+
+		// Заполняет маски для size байт начиная с data, по одной паре масок на каждые CHUNK_SIZE байт
+		void IndexBlock(const char* data, size_t size, ChunkMasks* masks) {
+			static const IndexFunction index = SelectIndexFunction();
+			index(data, size, masks);
+		}
+
+		// Курсор по входу. Поток читается блоками по BLOCK_SIZE байт, буфер в памяти просматривается
+		// окнами того же размера без копирования. Для каждого блока сначала строятся маски непробельных
+		// символов и границ строк, и пропуск пробелов и чтение строк идут по ним, а не по символам.
+		// Каждый символ просматривается один раз, поэтому разбор линеен по размеру входа
+		class Cursor {
+		public:
+			explicit Cursor(std::istream& input)
+				: source_(input.rdbuf())
+				, block_(BLOCK_SIZE)
+				, masks_(BLOCK_SIZE / CHUNK_SIZE) {
+			}
+
+			explicit Cursor(std::string_view input)
+				: position_(input.data())
+				, end_(input.data())
+				, memory_end_(input.data() + input.size())
+				, masks_(BLOCK_SIZE / CHUNK_SIZE) {
+			}
+
+			bool AtEnd() {
+				return position_ == end_ && !Refill();
+			}
+
+			char Peek() {
+				if (AtEnd()) {
+					throw ParsingError("Unexpected end of input");
+				}
+				return *position_;
+			}
+
+			char Get() {
+				const char c = Peek();
+				++position_;
+				return c;
+			}
+
+			void Expect(char expected) {
+				if (Get() != expected) {
+					throw ParsingError(std::string("Expected '") + expected + "'");
+				}
+			}
+
+			// Между лексемами обычно нет пробелов или стоит один, поэтому сначала проверяется текущий символ
+			void SkipSpaces() {
+				while (!AtEnd()) {
+					if (!IsSpace(*position_)) {
+						return;
+					}
+					position_ = FindMarked(&ChunkMasks::non_space);
+					if (position_ != end_) {
+						return;
+					}
+				}
+			}
+
+			// Символы текущего блока до кавычки или обратной косой черты, без копирования.
+			// Следующий блок не читается: если такого символа в блоке нет, возвращается остаток блока
+			std::string_view ReadStringSpan() {
+				const char* begin = position_;
+				if (position_ != end_) {
+					position_ = FindMarked(&ChunkMasks::string_stop);
+				}
+				return { begin, static_cast<size_t>(position_ - begin) };
+			}
+
+			// Дописывает в result символы до кавычки или обратной косой черты; сама она не извлекается
+			void ReadString(std::string& result) {
+				while (!AtEnd()) {
+					const char* stop = FindMarked(&ChunkMasks::string_stop);
+					result.append(position_, stop);
+					position_ = stop;
+					if (stop != end_) {
+						return;
+					}
+				}
+			}
+
+			// Символы текущего блока до первого, для которого is_stop истинно, без копирования.
+			// Следующий блок не читается: если стоп-символа в блоке нет, возвращается остаток блока
+			template <typename IsStop>
+			std::string_view ReadSpan(IsStop is_stop) {
+				const char* begin = position_;
+				position_ = std::find_if(position_, end_, is_stop);
+				return { begin, static_cast<size_t>(position_ - begin) };
+			}
+
+			// Остановился ли курсор внутри текущего блока
+			bool InBlock() const {
+				return position_ != end_;
+			}
+
+			// Стоит ли курсор на символе c внутри текущего блока
+			bool StopsAt(char c) const {
+				return position_ != end_ && *position_ == c;
+			}
+
+			// Дописывает в result символы до первого, для которого is_stop истинно; сам он не извлекается
+			template <typename IsStop>
+			void ReadUntil(std::string& result, IsStop is_stop) {
+				while (!AtEnd()) {
+					const char* stop = std::find_if(position_, end_, is_stop);
+					result.append(position_, stop);
+					position_ = stop;
+					if (stop != end_) {
+						return;
+					}
+				}
+			}
+
+		private:
+			static constexpr size_t BLOCK_SIZE = 1 << 16;
+
+			std::streambuf* source_ = nullptr;
+			std::vector<char> block_;
+			// Начало текущего блока: к нему привязаны маски
+			const char* block_begin_ = nullptr;
+			const char* position_ = nullptr;
+			const char* end_ = nullptr;
+			// Конец входа в памяти; для потока не используется
+			const char* memory_end_ = nullptr;
+			std::vector<ChunkMasks> masks_;
+
+			bool Refill() {
+				if (source_ != nullptr) {
+					const std::streamsize count = source_->sgetn(block_.data(), static_cast<std::streamsize>(block_.size()));
+					block_begin_ = block_.data();
+					end_ = block_.data() + std::max<std::streamsize>(count, 0);
+				} else {
+					block_begin_ = end_;
+					end_ += std::min<size_t>(memory_end_ - end_, BLOCK_SIZE);
+				}
+				position_ = block_begin_;
+				IndexBlock(block_begin_, static_cast<size_t>(end_ - block_begin_), masks_.data());
+				return position_ != end_;
+			}
+
+			static bool IsSpace(char c) {
+				return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+			}
+
+			// Первый отмеченный в маске field символ не раньше position_ или end_, если такого нет.
+			// Курсор должен стоять внутри блока
+			const char* FindMarked(uint64_t ChunkMasks::* field) const {
+				const size_t offset = static_cast<size_t>(position_ - block_begin_);
+				const size_t chunk_count = (static_cast<size_t>(end_ - block_begin_) + CHUNK_SIZE - 1) / CHUNK_SIZE;
+				size_t chunk = offset / CHUNK_SIZE;
+				uint64_t bits = masks_[chunk].*field & (~uint64_t{ 0 } << (offset % CHUNK_SIZE));
+				while (bits == 0) {
+					if (++chunk == chunk_count) {
+						return end_;
+					}
+					bits = masks_[chunk].*field;
+				}
+				return block_begin_ + chunk * CHUNK_SIZE + std::countr_zero(bits);
+			}
+		};
+
+		// Разбор рекурсивным спуском: события отдаются обработчику по мере чтения, без поиска парных скобок
+		class Parser {
+		public:
+			Parser(Cursor& cursor, Handler& handler)
+				: cursor_(cursor)
+				, handler_(handler) {
+			}
+
+			// Корневое значение; после него во входе допустимы только пробельные символы
+			void Parse() {
+				ParseValue(0);
+				cursor_.SkipSpaces();
+				if (!cursor_.AtEnd()) {
+					throw ParsingError("Unexpected data after JSON value");
+				}
+			}
+
+		private:
+			// Ограничение вложенности защищает стек вызовов от переполнения
+			static constexpr int MAX_DEPTH = 10000;
+
+			Cursor& cursor_;
+			Handler& handler_;
+			// Буфер строк с escape-последовательностями и чисел, переиспользуется между значениями
+			std::string scratch_;
+
+			void ParseValue(int depth) {
+				if (depth > MAX_DEPTH) {
+					throw ParsingError("Nesting is too deep");
+				}
+				cursor_.SkipSpaces();
+				switch (cursor_.Peek()) {
+				case '{': ParseMap(depth); break;
+				case '[': ParseArray(depth); break;
+				case '\"': handler_.Value(Node{ StringRef{ ParseString() } }); break;
+				case 'n': ExpectWord("null"); handler_.Value(Node{ nullptr }); break;
+				case 't': ExpectWord("true"); handler_.Value(Node{ true }); break;
+				case 'f': ExpectWord("false"); handler_.Value(Node{ false }); break;
+				default: handler_.Value(ParseNumber());
+				}
+			}
+
+			void ParseArray(int depth) {
+				cursor_.Expect('[');
+				handler_.StartArray();
+				cursor_.SkipSpaces();
+				if (cursor_.Peek() == ']') {
+					cursor_.Get();
+					handler_.EndArray();
+					return;
+				}
+				while (true) {
+					ParseValue(depth + 1);
+					cursor_.SkipSpaces();
+					if (cursor_.Peek() == ']') {
+						cursor_.Get();
+						handler_.EndArray();
+						return;
+					}
+					cursor_.Expect(',');
+				}
+			}
+
+			void ParseMap(int depth) {
+				cursor_.Expect('{');
+				handler_.StartMap();
+				cursor_.SkipSpaces();
+				if (cursor_.Peek() == '}') {
+					cursor_.Get();
+					handler_.EndMap();
+					return;
+				}
+				while (true) {
+					cursor_.SkipSpaces();
+					handler_.Key(ParseString());
+					cursor_.SkipSpaces();
+					cursor_.Expect(':');
+					ParseValue(depth + 1);
+					cursor_.SkipSpaces();
+					if (cursor_.Peek() == '}') {
+						cursor_.Get();
+						handler_.EndMap();
+						return;
+					}
+					cursor_.Expect(',');
+				}
+			}
+
+			// Строка без escape-последовательностей внутри блока возвращается ссылкой на вход,
+			// остальные собираются в scratch_. Ссылка действительна до следующего вызова
+			std::string_view ParseString() {
+				cursor_.Expect('\"');
+				const std::string_view head = cursor_.ReadStringSpan();
+				if (cursor_.StopsAt('\"')) {
+					cursor_.Get();
+					return head;
+				}
+				scratch_.assign(head);
+				while (true) {
+					cursor_.ReadString(scratch_);
+					if (cursor_.Get() == '\"') {
+						return scratch_;
+					}
+					ParseEscape(scratch_);
+				}
+			}
+
+			void ParseEscape(std::string& result) {
+				switch (const char c = cursor_.Get()) {
+				case 'r':  result += '\r'; break;
+				case 'n':  result += '\n'; break;
+				case 't':  result += '\t'; break;
+				case 'b':  result += '\b'; break;
+				case 'f':  result += '\f'; break;
+				case '"':  result += '\"'; break;
+				case '\\': result += '\\'; break;
+				case '/':  result += '/'; break;
+				case 'u':  AppendUtf8(result, ParseCodePoint()); break;
+				default:   throw ParsingError(std::string("Invalid escape sequence \\") + c);
+				}
+			}
+
+			// \uXXXX, для символов вне базовой плоскости - суррогатная пара
+			uint32_t ParseCodePoint() {
+				uint32_t code = ParseHex();
+				if (code >= 0xD800 && code <= 0xDBFF) {
+					cursor_.Expect('\\');
+					cursor_.Expect('u');
+					const uint32_t low = ParseHex();
+					if (low < 0xDC00 || low > 0xDFFF) {
+						throw ParsingError("Invalid surrogate pair");
+					}
+					code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+				}
+				return code;
+			}
+
+			uint32_t ParseHex() {
+				char digits[4];
+				for (char& digit : digits) {
+					digit = cursor_.Get();
+				}
+				uint32_t code = 0;
+				const auto [end, error] = std::from_chars(digits, digits + 4, code, 16);
+				if (error != std::errc{} || end != digits + 4) {
+					throw ParsingError("Invalid \\u escape");
+				}
+				return code;
+			}
+
+			static void AppendUtf8(std::string& result, uint32_t code) {
+				if (code < 0x80) {
+					result += static_cast<char>(code);
+				} else if (code < 0x800) {
+					result += static_cast<char>(0xC0 | (code >> 6));
+					result += static_cast<char>(0x80 | (code & 0x3F));
+				} else if (code < 0x10000) {
+					result += static_cast<char>(0xE0 | (code >> 12));
+					result += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+					result += static_cast<char>(0x80 | (code & 0x3F));
+				} else {
+					result += static_cast<char>(0xF0 | (code >> 18));
+					result += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+					result += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+					result += static_cast<char>(0x80 | (code & 0x3F));
+				}
+			}
+
+			void ExpectWord(std::string_view word) {
+				for (const char c : word) {
+					if (cursor_.AtEnd() || cursor_.Get() != c) {
+						throw ParsingError("Invalid Primitive");
+					}
+				}
+			}
+
+			static bool IsNumberStop(char c) {
+				return !std::isdigit(static_cast<unsigned char>(c)) && c != '.' && c != '+' && c != '-' && c != 'e' && c != 'E';
+			}
+
+			// Число без дробной части и экспоненты, которое помещается в int, - Int, остальные - Double.
+			// Число внутри блока разбирается прямо во входе, на границе блока собирается в scratch_
+			Node ParseNumber() {
+				std::string_view text = cursor_.ReadSpan(IsNumberStop);
+				if (!cursor_.InBlock()) {
+					scratch_.assign(text);
+					cursor_.ReadUntil(scratch_, IsNumberStop);
+					text = scratch_;
+				}
+				if (text.empty()) {
+					throw ParsingError("Invalid Number");
+				}
+				const char* begin = text.data();
+				const char* end = text.data() + text.size();
+				if (text.find_first_of(".eE") == std::string_view::npos) {
+					int value = 0;
+					if (const auto [last, error] = std::from_chars(begin, end, value); error == std::errc{} && last == end) {
+						return Node{ value };
+					}
+				}
+				double value = 0;
+				if (const auto [last, error] = std::from_chars(begin, end, value); error != std::errc{} || last != end) {
+					throw ParsingError("Invalid Number");
+				}
+				return Node{ value };
+			}
+		};
+
+		std::string StringSerialization(std::string_view str) {
+			std::string result;
+			for (char c : str) {
+				switch (c) {
+				case '\r': result += "\\r"; break;
+				case '\n': result += "\\n"; break;
+				case '\t': result += "\\t"; break;
+				case '\"': result += "\\\""; break;
+				case '\\': result += "\\\\"; break;
+				default:   result += c;
+				}
+			}
+			return "\"" + result + "\"";
+		}
+
+		std::string MakeIndent(int level) {
+			static const int indent = 4;
+			return std::string(level * indent, ' ');
+		}
+
+		void PrintArray(const Node& node, std::ostream& output, int level = 0) {
+			const Array& arr = node.AsArray();
+			if (arr.empty()) {
+				output << "[]";
+				return;
+			}
+
+			output << "[\n";
+			for (auto it = arr.begin(); it != arr.end(); ++it) {
+				output << MakeIndent(level + 1);
+				PrintNode(*it, output, level + 1);
+				output << (it == std::prev(arr.end()) ? "\n" : ",\n");
+			}
+			output << MakeIndent(level) << "]";
+		}
+
+		void PrintMap(const Node& node, std::ostream& output, int level = 0) {
+			const Dict& map = node.AsMap();
+			if (map.empty()) {
+				output << "{}";
+				return;
+			}
+
+			output << "{\n";
+			for (auto it = map.begin(); it != map.end(); ++it) {
+				const auto& [key, value] = *it;
+				output << MakeIndent(level + 1) << "\"" << key << "\": ";
+				PrintNode(value, output, level + 1);
+				output << (it == std::prev(map.end()) ? "\n" : ",\n");
+			}
+			output << MakeIndent(level) << "}";
+		}
+
+	}  // namespace detail
+
+	//-----Node-----
+
+	bool Node::IsNull() const {
+		return std::holds_alternative<std::nullptr_t>(*this);
+	}
+
+	bool Node::IsBool() const {
+		return std::holds_alternative<bool>(*this);
+	}
+
+	bool Node::IsInt() const {
+		return std::holds_alternative<int>(*this);
+	}
+
+	bool Node::IsDouble() const {
+		return IsPureDouble() || IsInt();
+	}
+
+	bool Node::IsPureDouble() const {
+		return std::holds_alternative<double>(*this);
+	}
+
+	bool Node::IsString() const {
+		return std::holds_alternative<std::string>(*this) || std::holds_alternative<StringRef>(*this);
+	}
+
+	bool Node::IsArray() const {
+		return std::holds_alternative<json::Array>(*this);
+	}
+
+	bool Node::IsMap() const {
+		return std::holds_alternative<json::Dict>(*this);
+	}
+
+	bool Node::AsBool() const {
+		if (!IsBool()) {
+			throw(std::logic_error("Invalid Bool"));
+		}
+		return get<bool>(*this);
+	}
+
+	int Node::AsInt() const {
+		if (!IsInt()) {
+			throw(std::logic_error("Invalid Int"));
+		}
+		return get<int>(*this);
+	}
+
+	double Node::AsDouble() const {
+		if (!IsDouble()) {
+			throw(std::logic_error("Invalid Double"));
+		}
+		return IsPureDouble() ? get<double>(*this) : static_cast<double>(AsInt());
+	}
+
+	std::string_view Node::AsString() const {
+		if (const StringRef* ref = std::get_if<StringRef>(this)) {
+			return ref->value;
+		}
+		if (!IsString()) {
+			throw(std::logic_error("Invalid String"));
+		}
+		return get<std::string>(*this);
+	}
+
+	const Array& Node::AsArray() const {
+		return const_cast<Node*>(this)->AsArray();
+	}
+
+	const Dict& Node::AsMap() const {
+		return const_cast<Node*>(this)->AsMap();
+	}
+
+	Array& Node::AsArray() {
+		if (!IsArray()) {
+			throw(std::logic_error("Invalid Array"));
+		}
+		return get<Array>(*this);
+	}
+
+	Dict& Node::AsMap() {
+		if (!IsMap()) {
+			throw(std::logic_error("Invalid Map"));
+		}
+		return get<Dict>(*this);
+	}
+
+
+	bool operator==(const Node& lhs, const Node& rhs) {
+		if (lhs.IsNull() && rhs.IsNull()) {
+			return true;
+		}
+
+		if (lhs.IsBool() && rhs.IsBool()) {
+			return lhs.AsBool() == rhs.AsBool();
+		}
+
+		if (lhs.IsInt() && rhs.IsInt()) {
+			return lhs.AsInt() == rhs.AsInt();
+		}
+
+		if (lhs.IsPureDouble() && rhs.IsPureDouble()) {
+			return lhs.AsDouble() == rhs.AsDouble();
+		}
+
+		if (lhs.IsString() && rhs.IsString()) {
+			return lhs.AsString() == rhs.AsString();
+		}
+
+		if (lhs.IsArray() && rhs.IsArray()) {
+			return lhs.AsArray() == rhs.AsArray();
+		}
+
+		if (lhs.IsMap() && rhs.IsMap()) {
+			return lhs.AsMap() == rhs.AsMap();
+		}
+
+		return false;
+	}
+
+	//-----Dict-----
+
+	Dict::Dict(const allocator_type& allocator)
+		: entries_(allocator) {
+	}
+
+	// Устойчивая сортировка сохраняет порядок входа среди равных ключей, и остаётся первая пара.
+	// Короткий словарь сортируется вставками: stable_sort выделял бы буфер на каждый объект
+	Dict::Dict(Entries entries)
+		: entries_(std::move(entries)) {
+		if (entries_.size() <= INSERTION_SORT_SIZE) {
+			for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+				const auto position = std::upper_bound(entries_.begin(), it, it->first,
+					[](const std::pmr::string& value, const Entry& entry) { return value < entry.first; });
+				std::rotate(position, it, std::next(it));
+			}
+		} else {
+			std::ranges::stable_sort(entries_, {}, &Entry::first);
+		}
+		const auto duplicates = std::ranges::unique(entries_, {}, &Entry::first);
+		entries_.erase(duplicates.begin(), duplicates.end());
+	}
+
+	Dict::iterator Dict::begin() {
+		return entries_.begin();
+	}
+
+	Dict::iterator Dict::end() {
+		return entries_.end();
+	}
+
+	Dict::const_iterator Dict::begin() const {
+		return entries_.begin();
+	}
+
+	Dict::const_iterator Dict::end() const {
+		return entries_.end();
+	}
+
+	size_t Dict::size() const {
+		return entries_.size();
+	}
+
+	bool Dict::empty() const {
+		return entries_.empty();
+	}
+
+	Dict::iterator Dict::find(std::string_view key) {
+		const auto position = std::lower_bound(entries_.begin(), entries_.end(), key,
+			[](const Entry& entry, std::string_view value) { return entry.first < value; });
+		return position != entries_.end() && position->first == key ? position : entries_.end();
+	}
+
+	Dict::const_iterator Dict::find(std::string_view key) const {
+		return const_cast<Dict*>(this)->find(key);
+	}
+
+	size_t Dict::count(std::string_view key) const {
+		return find(key) != end() ? 1 : 0;
+	}
+
+	Node& Dict::at(std::string_view key) {
+		const auto position = find(key);
+		if (position == end()) {
+			throw std::out_of_range("Key not found: " + std::string(key));
+		}
+		return position->second;
+	}
+
+	const Node& Dict::at(std::string_view key) const {
+		return const_cast<Dict*>(this)->at(key);
+	}
+
+	bool Dict::operator==(const Dict& other) const {
+		return std::ranges::equal(entries_, other.entries_);
+	}
+
+	//-----TreeBuilder-----
+
+	TreeBuilder::TreeBuilder()
+		: storage_(std::make_shared<DocumentStorage>()) {
+	}
+
+	TreeBuilder::TreeBuilder(std::string input)
+		: TreeBuilder() {
+		storage_->input = std::move(input);
+	}
+
+	std::string_view TreeBuilder::GetInput() const {
+		return storage_->input;
+	}
+
+	void TreeBuilder::StartMap() {
+		open_nodes_.emplace_back(Dict(&storage_->arena));
+		open_map_starts_.push_back(open_entries_.size());
+	}
+
+	void TreeBuilder::Key(std::string_view key) {
+		keys_.emplace_back(key, &storage_->arena);
+	}
+
+	void TreeBuilder::EndMap() {
+		CloseNode();
+	}
+
+	void TreeBuilder::StartArray() {
+		open_nodes_.emplace_back(Array(&storage_->arena));
+	}
+
+	void TreeBuilder::EndArray() {
+		CloseNode();
+	}
+
+	void TreeBuilder::Value(Node value) {
+		if (value.IsString()) {
+			Attach(Node{ StringRef{ Store(value.AsString()) } });
+			return;
+		}
+		Attach(std::move(value));
+	}
+
+	Document TreeBuilder::Extract() {
+		Document result(std::exchange(root_, Node{}), std::exchange(storage_, std::make_shared<DocumentStorage>()));
+		open_nodes_.clear();
+		open_entries_.clear();
+		open_map_starts_.clear();
+		keys_.clear();
+		return result;
+	}
+
+	std::string_view TreeBuilder::Store(std::string_view text) {
+		const std::string_view input = storage_->input;
+		if (text.data() >= input.data() && text.data() + text.size() <= input.data() + input.size()) {
+			return text;
+		}
+		if (text.empty()) {
+			return {};
+		}
+		char* copy = static_cast<char*>(storage_->arena.allocate(text.size(), 1));
+		std::copy(text.begin(), text.end(), copy);
+		return { copy, text.size() };
+	}
+
+	void TreeBuilder::CloseNode() {
+		Node node = std::move(open_nodes_.back());
+		open_nodes_.pop_back();
+		if (node.IsMap()) {
+			const auto first = open_entries_.begin() + static_cast<std::ptrdiff_t>(open_map_starts_.back());
+			Dict::Entries entries(&storage_->arena);
+			entries.reserve(static_cast<size_t>(open_entries_.end() - first));
+			std::move(first, open_entries_.end(), std::back_inserter(entries));
+			open_entries_.erase(first, open_entries_.end());
+			open_map_starts_.pop_back();
+			node = Node{ Dict(std::move(entries)) };
+		}
+		Attach(std::move(node));
+	}
+
+	// Готовый узел становится элементом открытого массива, значением последнего ключа или корнем
+	void TreeBuilder::Attach(Node value) {
+		if (open_nodes_.empty()) {
+			root_ = std::move(value);
+			return;
+		}
+		Node& parent = open_nodes_.back();
+		if (parent.IsArray()) {
+			parent.AsArray().push_back(std::move(value));
+			return;
+		}
+		open_entries_.emplace_back(std::move(keys_.back()), std::move(value));
+		keys_.pop_back();
+	}
+
+	//-----Document-----
+
+	Document::Document(Node root)
+		: root_(std::move(root)) {
+	}
+
+	Document::Document(Node root, std::shared_ptr<DocumentStorage> storage)
+		: storage_(std::move(storage))
+		, root_(std::move(root)) {
+	}
+
+	const Node& Document::GetRoot() const {
+		return root_;
+	}
+
+	void Parse(istream& input, Handler& handler) {
+		detail::Cursor cursor(input);
+		detail::Parser(cursor, handler).Parse();
+	}
+
+	void Parse(std::string_view input, Handler& handler) {
+		detail::Cursor cursor(input);
+		detail::Parser(cursor, handler).Parse();
+	}
+
+	Document Load(istream& input) {
+		TreeBuilder builder;
+		Parse(input, builder);
+		return builder.Extract();
+	}
+
+	Document Load(std::string input) {
+		TreeBuilder builder(std::move(input));
+		Parse(builder.GetInput(), builder);
+		return builder.Extract();
+	}
+
+	bool operator==(const Document& lhs, const Document& rhs) {
+		return lhs.GetRoot() == rhs.GetRoot();
+	}
+
+	void Print(const Document& doc, std::ostream& output) {
+		PrintNode(doc.GetRoot(), output);
+	}
+
+	void PrintNode(const Node& node, std::ostream& output, int level) {
+		if (node.IsNull()) {
+			output << "null";
+			return;
+		}
+
+		if (node.IsBool()) {
+			output << (node.AsBool() ? "true" : "false");
+			return;
+		}
+
+		if (node.IsInt()) {
+			output << node.AsInt();
+			return;
+		}
+
+		if (node.IsPureDouble()) {
+			output << node.AsDouble();
+			return;
+		}
+
+		if (node.IsString()) {
+			output << detail::StringSerialization(node.AsString());
+			return;
+		}
+
+		if (node.IsArray()) {
+			detail::PrintArray(node, output, level);
+		}
+
+		if (node.IsMap()) {
+			detail::PrintMap(node, output, level);
+		}
+	}
 }  // namespace json
\ No newline at end of file
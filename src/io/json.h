@@ -1,67 +1,209 @@
-#pragma once
-
-#include <iostream>
-#include <map>
-#include <string>
-#include <vector>
-#include <variant>
-
-namespace json {
-
-	class Node;
-	// Псеводнимы основных сущностей JSON
-	using Dict = std::map<std::string, Node>;
-	using Array = std::vector<Node>;
-
-	// Исключение при ошибках парсинга JSON
-	class ParsingError : public std::runtime_error {
-	public:
-		using runtime_error::runtime_error;
-	};
-
-	class Node
-		: private std::variant<std::nullptr_t, bool, int, double, std::string, Array, Dict> {
-	public:
-		using variant::variant;
-		
-		bool IsNull() const;
-		bool IsBool() const;
-		bool IsInt() const;
-		bool IsDouble() const;
-		bool IsPureDouble() const;
-		bool IsString() const;
-		bool IsArray() const;
-		bool IsMap() const;
-
-		bool AsBool() const;
-		int AsInt() const;
-		double AsDouble() const;
-		const std::string& AsString() const;
-		const Array& AsArray() const;
-		const Dict& AsMap() const;
-
-		Array& AsArray();
-		Dict& AsMap();
-	};
-
-	bool operator==(const Node& lhs, const Node& rhs);
-
-	class Document {
-	public:
-		explicit Document(Node root);
-
-		const Node& GetRoot() const;
-
-	private:
-		Node root_;
-	};
-
-	Document Load(std::istream& input);
-
-	bool operator==(const Document& lhs, const Document& rhs);
-
-	void Print(const Document& doc, std::ostream& output);
-
-	void PrintNode(const Node& node, std::ostream& output, int level = 0);
-
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include <variant>
+
+namespace json {
+
+	class Node;
+	// Контейнеры JSON берут память из memory_resource:
+	// у загруженного документа это его арена, у построенных в программе - обычная куча
+	using Array = std::pmr::vector<Node>;
+
+	// Словарь JSON: пары подряд в одном векторе, упорядоченные по ключу. У типичного объекта
+	// 3-6 ключей: поиск по соседним элементам дешевле обхода дерева, а вставка не выделяет
+	// память под каждый ключ. Хранить первые пары внутри самого словаря нельзя: Dict входит
+	// в Node, и размер Node стал бы бесконечным
+	class Dict {
+	public:
+		using Entry = std::pair<std::pmr::string, Node>;
+		using Entries = std::pmr::vector<Entry>;
+		using allocator_type = Entries::allocator_type;
+		using iterator = Entries::iterator;
+		using const_iterator = Entries::const_iterator;
+
+		Dict() = default;
+		explicit Dict(const allocator_type& allocator);
+		// Пары в любом порядке, из пар с одинаковым ключом остаётся первая
+		explicit Dict(Entries entries);
+
+		iterator begin();
+		iterator end();
+		const_iterator begin() const;
+		const_iterator end() const;
+		size_t size() const;
+		bool empty() const;
+
+		iterator find(std::string_view key);
+		const_iterator find(std::string_view key) const;
+		size_t count(std::string_view key) const;
+		// std::out_of_range, если ключа нет
+		Node& at(std::string_view key);
+		const Node& at(std::string_view key) const;
+
+		// Как у std::map: существующий ключ не перезаписывается, second == false
+		template <typename Key, typename... Args>
+		std::pair<iterator, bool> emplace(Key&& key, Args&&... args);
+
+		bool operator==(const Dict& other) const;
+
+	private:
+		// Ёмкость при первой вставке: типичный объект помещается в один блок памяти
+		static constexpr size_t INITIAL_CAPACITY = 4;
+		static constexpr size_t INSERTION_SORT_SIZE = 16;
+
+		Entries entries_;
+	};
+
+	// Строка, которая не владеет символами, а ссылается на память документа
+	struct StringRef {
+		std::string_view value;
+	};
+
+	// Исключение при ошибках парсинга JSON
+	class ParsingError : public std::runtime_error {
+	public:
+		using runtime_error::runtime_error;
+	};
+
+	class Node
+		: private std::variant<std::nullptr_t, bool, int, double, std::string, StringRef, Array, Dict> {
+	public:
+		using variant::variant;
+		
+		bool IsNull() const;
+		bool IsBool() const;
+		bool IsInt() const;
+		bool IsDouble() const;
+		bool IsPureDouble() const;
+		bool IsString() const;
+		bool IsArray() const;
+		bool IsMap() const;
+
+		bool AsBool() const;
+		int AsInt() const;
+		double AsDouble() const;
+		// Строки-копии и строки-ссылки на документ читаются одинаково
+		std::string_view AsString() const;
+		const Array& AsArray() const;
+		const Dict& AsMap() const;
+
+		Array& AsArray();
+		Dict& AsMap();
+	};
+
+	bool operator==(const Node& lhs, const Node& rhs);
+
+	template <typename Key, typename... Args>
+	std::pair<Dict::iterator, bool> Dict::emplace(Key&& key, Args&&... args) {
+		const std::string_view key_view = key;
+		const auto position = std::lower_bound(entries_.begin(), entries_.end(), key_view,
+			[](const Entry& entry, std::string_view value) { return entry.first < value; });
+		if (position != entries_.end() && position->first == key_view) {
+			return { position, false };
+		}
+		const size_t index = static_cast<size_t>(position - entries_.begin());
+		if (entries_.size() == entries_.capacity() && entries_.capacity() < INITIAL_CAPACITY) {
+			entries_.reserve(INITIAL_CAPACITY);
+		}
+		const auto inserted = entries_.emplace(entries_.begin() + index, std::piecewise_construct,
+			std::forward_as_tuple(std::forward<Key>(key)), std::forward_as_tuple(std::forward<Args>(args)...));
+		return { inserted, true };
+	}
+
+	// Память загруженного документа. Словари, массивы и копии строк размещаются в арене
+	// и освобождаются разом вместе с документом. Строки без escape-последовательностей
+	// ссылаются прямо на input, если вход был передан в память документа
+	struct DocumentStorage {
+		std::string input;
+		std::pmr::monotonic_buffer_resource arena;
+	};
+
+	class Document {
+	public:
+		explicit Document(Node root);
+		// Узлы root ссылаются на storage, копии документа разделяют её
+		Document(Node root, std::shared_ptr<DocumentStorage> storage);
+
+		const Node& GetRoot() const;
+
+	private:
+		std::shared_ptr<DocumentStorage> storage_;
+		Node root_;
+	};
+
+	// Получатель событий потокового разбора. Parse вызывает методы в порядке следования
+	// значений во входе, не строя дерево. Value получает скаляры: null, bool, число или строку.
+	// Ключи и строки - ссылки на буфер разбора, действительные только до возврата из вызова
+	class Handler {
+	public:
+		virtual ~Handler() = default;
+
+		virtual void StartMap() = 0;
+		virtual void Key(std::string_view key) = 0;
+		virtual void EndMap() = 0;
+		virtual void StartArray() = 0;
+		virtual void EndArray() = 0;
+		virtual void Value(Node value) = 0;
+	};
+
+	// Собирает дерево узлов из событий разбора в арене будущего документа, на нём построен Load
+	class TreeBuilder : public Handler {
+	public:
+		TreeBuilder();
+		// Вход хранится в документе, и строки из него не копируются: разбирать нужно GetInput()
+		explicit TreeBuilder(std::string input);
+
+		std::string_view GetInput() const;
+
+		void StartMap() override;
+		void Key(std::string_view key) override;
+		void EndMap() override;
+		void StartArray() override;
+		void EndArray() override;
+		void Value(Node value) override;
+
+		// Собранный документ, после вызова построитель пуст
+		Document Extract();
+
+	private:
+		std::shared_ptr<DocumentStorage> storage_;
+		// Открытые словари и массивы от корня вглубь и ключи открытых словарей.
+		// Пары открытых словарей копятся подряд в open_entries_, начало каждого - в open_map_starts_.
+		// При закрытии словарь получает в арене блок точного размера и упорядочивается один раз
+		std::vector<Node> open_nodes_;
+		std::vector<Dict::Entry> open_entries_;
+		std::vector<size_t> open_map_starts_;
+		std::vector<std::pmr::string> keys_;
+		Node root_;
+
+		// Строка, которая переживёт разбор: ссылка на вход документа или копия в арене
+		std::string_view Store(std::string_view text);
+		void CloseNode();
+		void Attach(Node value);
+	};
+
+	// Разбирает вход целиком: после корневого значения допустимы только пробельные символы
+	void Parse(std::istream& input, Handler& handler);
+	void Parse(std::string_view input, Handler& handler);
+
+	Document Load(std::istream& input);
+	// Документ забирает input себе, строки без escape-последовательностей ссылаются на него
+	Document Load(std::string input);
+
+	bool operator==(const Document& lhs, const Document& rhs);
+
+	void Print(const Document& doc, std::ostream& output);
+
+	void PrintNode(const Node& node, std::ostream& output, int level = 0);
+
 }  // namespace json
\ No newline at end of file
@@ -1,284 +1,715 @@
-#include "json_reader.h"
-
-#include <string>
-#include <vector>
-#include <deque>
-#include <unordered_map>
-
-#include "geo.h"
-#include "json_builder.h"
-
-namespace json_reader {
-	using namespace json;
-	using namespace request_handler;
-	namespace detail {
-		BusRequest ParseBus(const Dict& req) {
-			BusRequest bus_req{
-					.name = req.at("name").AsString(),
-					.stops{},
-					.is_roundtrip = req.at("is_roundtrip").AsBool()
-			};
-			const Array& stops = req.at("stops").AsArray();
-			for (const Node& stop : stops) {
-				bus_req.stops.emplace_back(stop.AsString());
-			}
-			return bus_req;
-		}
-
-		StopRequest ParseStop(const Dict& req) {
-			StopRequest stop_req{
-				.name = req.at("name").AsString(),
-				.pos{
-					.lat = req.at("latitude").AsDouble(),
-					.lng = req.at("longitude").AsDouble()
-				},
-				.road_distances{}
-			};
-			const Dict& road_distances = req.at("road_distances").AsMap();
-			for (const auto& [name, dist] : road_distances) {
-				stop_req.road_distances.emplace(name, dist.AsInt());
-			}
-			return stop_req;
-		}
-
-		StatRequest ParseStat(const Dict& req) {
-			StatRequest stat_req{
-				.id = req.at("id").AsInt(),
-				.type = req.at("type").AsString(),
-				.name = req.count("name") ? req.at("name").AsString() : "",
-				.from = req.count("from") ? req.at("from").AsString() : "",
-				.to = req.count("to") ? req.at("to").AsString() : ""
-			};
-			return stat_req;
-		}
-
-		Node ParseInfo(int id, const Info& info) {
-			using namespace std::literals;
-			if (std::holds_alternative<std::monostate>(info)) {
-				return Builder{}.StartDict()
-					.Key("request_id"s).Value(id)
-					.Key("error_message"s).Value("not found"s)
-					.EndDict().Build();
-			}
-
-			if (std::holds_alternative<InfoStop>(info)) {
-				InfoStop info_stop = get<InfoStop>(info);
-				Array arr;
-				for (auto bus : info_stop.cross_references) {
-					arr.emplace_back(std::string{ bus });
-				}
-				return Builder{}.StartDict()
-					.Key("request_id"s).Value(id)
-					.Key("buses"s).Value(arr)
-					.EndDict().Build();
-			}
-
-			if (std::holds_alternative<InfoRoute>(info)) {
-				InfoRoute info_route = get<InfoRoute>(info);
-				return Builder{}.StartDict()
-					.Key("request_id"s).Value(id)
-					.Key("curvature"s).Value(info_route.curvature)
-					.Key("route_length"s).Value(info_route.route_length)
-					.Key("stop_count"s).Value(info_route.number_total)
-					.Key("unique_stop_count"s).Value(info_route.number_unique)
-					.EndDict().Build();
-			}
-			return Node();
-		}
-
-		Node ParseRoute(int id, const std::optional<transport_router::InfoBuildRoute>& build_route) {
-			using namespace std::literals;
-			using namespace transport_router;
-			if (!build_route) {
-				return Builder{}.StartDict()
-					.Key("request_id"s).Value(id)
-					.Key("error_message"s).Value("not found"s)
-					.EndDict().Build();
-			}
-
-			Array arr;
-			for (const auto& edge : build_route.value().route) {
-				if (std::holds_alternative<EdgeWait>(edge)) {
-					EdgeWait e_wait = get<EdgeWait>(edge);
-					arr.push_back(
-						Builder{}.StartDict()
-						.Key("type").Value("Wait")
-						.Key("stop_name").Value(e_wait.stop->name)
-						.Key("time").Value(e_wait.time)
-						.EndDict().Build()
-					);
-				}
-
-				if (std::holds_alternative<EdgeBus>(edge)) {
-					EdgeBus e_bus = get<EdgeBus>(edge);
-					arr.push_back(
-						Builder{}.StartDict()
-						.Key("type").Value("Bus")
-						.Key("bus").Value(e_bus.route->name)
-						.Key("span_count").Value(e_bus.span_count)
-						.Key("time").Value(e_bus.time)
-						.EndDict().Build()
-					);
-				}
-			}
-
-			return Builder{}.StartDict()
-				.Key("request_id"s).Value(id)
-				.Key("items").Value(std::move(arr))
-				.Key("total_time").Value(build_route.value().total_weight)
-				.EndDict().Build();
-		}
-
-		Node GetMap(const StatRequest& req, const map_renderer::Renderer& renderer) {
-			std::ostringstream ss;
-			renderer.Drawing(ss);
-			return Builder{}.StartDict()
-				.Key("request_id").Value(req.id)
-				.Key("map").Value(ss.str())
-				.EndDict().Build();
-		}
-
-		svg::Color ParseColor(const Node& node) {
-			if (node.IsString()) {
-				return node.AsString();
-			}
-
-			if (node.IsArray()) {
-				const Array& arr = node.AsArray();
-				if (arr.size() == 3) {
-					return svg::Rgb(
-						static_cast<uint8_t>(arr[0].AsInt()),
-						static_cast<uint8_t>(arr[1].AsInt()),
-						static_cast<uint8_t>(arr[2].AsInt())
-					);
-				}
-				if (arr.size() == 4) {
-					return svg::Rgba(
-						static_cast<uint8_t>(arr[0].AsInt()),
-						static_cast<uint8_t>(arr[1].AsInt()),
-						static_cast<uint8_t>(arr[2].AsInt()),
-						arr[3].AsDouble()
-					);
-				}
-			}
-
-			return {};
-		}
-	} //namespace detail
-
-	void Reader::LoadDoc(std::istream& is) {
-		in_doc_ = json::Load(is);
-	}
-
-	void Reader::PrintDoc(std::ostream& os) {
-		json::Print(out_doc_, os);
-	}
-
-	void Reader::FillCatalogue(TransportCatalogue& catalogue) {
-		request_handler::FillCatalogue(ParseBaseRequest(), catalogue);
-	}
-
-	void Reader::GetData(const TransportCatalogue& catalogue, const map_renderer::Renderer& renderer, const transport_router::TransportRouter& router) {
-		Array arr;
-		std::vector<StatRequest> stat_requsetes = ParseStatRequest();
-		for (const StatRequest& req : stat_requsetes) {
-			if (req.type == "Map") {
-				arr.push_back(detail::GetMap(req, renderer));
-				continue;
-			}
-
-			if (req.type == "Route") {
-				auto route = router.BuildRoute(req.from, req.to);
-				arr.push_back(detail::ParseRoute(req.id, route));
-				continue;
-			}
-
-			Info info = request_handler::GetInfo(req, catalogue);
-			arr.push_back(detail::ParseInfo(req.id, info));
-		}
-
-		out_doc_ = Document{ arr };
-	}
-
-	void Reader::SetSettingRenderer(map_renderer::Renderer& renderer) {
-		renderer.SetSetting(ParseRenderSetting());
-	}
-
-	void Reader::SetSettingRouter(transport_router::TransportRouter& router) {
-		router.SetSetting(ParseRouterSetting());
-	}
-
-	std::deque<InData> Reader::ParseBaseRequest() {
-		std::deque<InData> result;
-		const Dict& objects = in_doc_.GetRoot().AsMap();
-		const Array& base_request = objects.at("base_requests").AsArray();
-
-		for (const Node& node : base_request) {
-			const Dict& req = node.AsMap();
-			// Остановки добавляются в начало дека для приоритетной обработки
-			if (req.at("type").AsString() == "Stop") {
-				result.emplace_front(detail::ParseStop(req));
-			}
-			// Маршруты добавляются без приоритета
-			if (req.at("type").AsString() == "Bus") {
-				result.emplace_back(detail::ParseBus(req));
-			}
-		}
-		return result;
-	}
-
-	std::vector<StatRequest> Reader::ParseStatRequest() {
-		std::vector<StatRequest> result;
-		const Dict& objects = in_doc_.GetRoot().AsMap();
-		const Array& stat_request = objects.at("stat_requests").AsArray();
-
-		for (const Node& node : stat_request) {
-			const Dict& req = node.AsMap();
-			result.emplace_back(detail::ParseStat(req));
-		}
-		return result;
-	}
-
-	map_renderer::RenderSetting Reader::ParseRenderSetting() {
-		const Dict& objects = in_doc_.GetRoot().AsMap();
-		const Dict& settings = objects.at("render_settings").AsMap();
-		map_renderer::RenderSetting result{
-			.width = settings.at("width").AsDouble(),
-			.height = settings.at("height").AsDouble(),
-			.padding = settings.at("padding").AsDouble(),
-			.line_width = settings.at("line_width").AsDouble(),
-			.stop_radius = settings.at("stop_radius").AsDouble(),
-			.bus_label_font_size = settings.at("bus_label_font_size").AsInt(),
-			.stop_label_font_size = settings.at("stop_label_font_size").AsInt(),
-			.bus_label_offset{},
-			.stop_label_offset{},
-			.underlayer_color{},
-			.underlayer_width = settings.at("underlayer_width").AsDouble(),
-			.color_palette{}
-		};
-		const Array& bus_offset = settings.at("bus_label_offset").AsArray();
-		const Array& stop_offset = settings.at("stop_label_offset").AsArray();
-		const Node& under_layer_color = settings.at("underlayer_color");
-		const Array& color_palette = settings.at("color_palette").AsArray();
-
-		result.bus_label_offset = svg::Point{ bus_offset[0].AsDouble(), bus_offset[1].AsDouble() };
-		result.stop_label_offset = svg::Point{ stop_offset[0].AsDouble(), stop_offset[1].AsDouble() };
-		result.underlayer_color = detail::ParseColor(under_layer_color);
-
-		for (const Node& node : color_palette) {
-			result.color_palette.emplace_back(detail::ParseColor(node));
-		}
-
-		return result;
-	}
-
-	transport_router::RoutingSetting Reader::ParseRouterSetting() {
-		const Dict& objects = in_doc_.GetRoot().AsMap();
-		const Dict& setting = objects.at("routing_settings").AsMap();
-		transport_router::RoutingSetting result{
-			.bus_wait = setting.at("bus_wait_time").AsInt(),
-			.bus_velocity = setting.at("bus_velocity").AsDouble()
-		};
-		return result;
-	}
+#include "json_reader.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+#include <cstdint>
+#include <ostream>
+#include <stdexcept>
+#include <streambuf>
+#include <utility>
+
+#include "geo.h"
+#include "json_builder.h"
+
+namespace json_reader {
+	using namespace json;
+	using namespace request_handler;
+	namespace detail {
+		StatRequest ParseStat(const Dict& req) {
+			StatRequest stat_req{
+				.id = req.at("id").AsInt(),
+				.type = std::string(req.at("type").AsString()),
+				.name = req.count("name") ? std::string(req.at("name").AsString()) : "",
+				.from = req.count("from") ? std::string(req.at("from").AsString()) : "",
+				.to = req.count("to") ? std::string(req.at("to").AsString()) : ""
+			};
+			if (req.count("origins")) {
+				for (const Node& stop : req.at("origins").AsArray()) {
+					stat_req.origins.emplace_back(stop.AsString());
+				}
+			}
+			if (req.count("destinations")) {
+				for (const Node& stop : req.at("destinations").AsArray()) {
+					stat_req.destinations.emplace_back(stop.AsString());
+				}
+			}
+			if (req.count("latitude") && req.count("longitude")) {
+				stat_req.point = { .lat = req.at("latitude").AsDouble(), .lng = req.at("longitude").AsDouble() };
+			}
+			if (req.count("radius")) {
+				stat_req.radius = req.at("radius").AsDouble();
+			}
+			if (req.count("count")) {
+				stat_req.count = req.at("count").AsInt();
+			}
+			return stat_req;
+		}
+
+		Node ParseInfo(int id, const Info& info) {
+			using namespace std::literals;
+			if (std::holds_alternative<std::monostate>(info)) {
+				return Builder{}.StartDict()
+					.Key("request_id"s).Value(id)
+					.Key("error_message"s).Value("not found"s)
+					.EndDict().Build();
+			}
+
+			if (std::holds_alternative<InfoStop>(info)) {
+				InfoStop info_stop = get<InfoStop>(info);
+				Array arr;
+				for (auto bus : info_stop.cross_references) {
+					arr.emplace_back(std::string{ bus });
+				}
+				return Builder{}.StartDict()
+					.Key("request_id"s).Value(id)
+					.Key("buses"s).Value(arr)
+					.EndDict().Build();
+			}
+
+			if (std::holds_alternative<InfoRoute>(info)) {
+				InfoRoute info_route = get<InfoRoute>(info);
+				return Builder{}.StartDict()
+					.Key("request_id"s).Value(id)
+					.Key("curvature"s).Value(info_route.curvature)
+					.Key("route_length"s).Value(info_route.route_length)
+					.Key("stop_count"s).Value(info_route.number_total)
+					.Key("unique_stop_count"s).Value(info_route.number_unique)
+					.EndDict().Build();
+			}
+			return Node();
+		}
+
+		Node ParseRoute(int id, const std::optional<transport_router::InfoBuildRoute>& build_route, bool report_stats) {
+			using namespace std::literals;
+			using namespace transport_router;
+			if (!build_route) {
+				return Builder{}.StartDict()
+					.Key("request_id"s).Value(id)
+					.Key("error_message"s).Value("not found"s)
+					.EndDict().Build();
+			}
+
+			Array arr;
+			for (const auto& edge : build_route.value().route) {
+				if (std::holds_alternative<EdgeWait>(edge)) {
+					EdgeWait e_wait = get<EdgeWait>(edge);
+					arr.push_back(
+						Builder{}.StartDict()
+						.Key("type").Value("Wait")
+						.Key("stop_name").Value(e_wait.stop->name)
+						.Key("time").Value(e_wait.time)
+						.EndDict().Build()
+					);
+				}
+
+				if (std::holds_alternative<EdgeBus>(edge)) {
+					EdgeBus e_bus = get<EdgeBus>(edge);
+					arr.push_back(
+						Builder{}.StartDict()
+						.Key("type").Value("Bus")
+						.Key("bus").Value(e_bus.route->name)
+						.Key("span_count").Value(e_bus.span_count)
+						.Key("time").Value(e_bus.time)
+						.EndDict().Build()
+					);
+				}
+			}
+
+			Node result = Builder{}.StartDict()
+				.Key("request_id"s).Value(id)
+				.Key("items").Value(std::move(arr))
+				.Key("total_time").Value(build_route.value().total_weight)
+				.EndDict().Build();
+			if (report_stats) {
+				const graph::SearchStats& stats = build_route.value().stats;
+				result.AsMap().emplace("settled_vertices", static_cast<int>(stats.settled_vertices));
+				result.AsMap().emplace("relaxed_edges", static_cast<int>(stats.relaxed_edges));
+			}
+			return result;
+		}
+
+		Node ParseRouteMatrix(int id, const std::vector<std::vector<std::optional<transport_router::Time>>>& matrix) {
+			using namespace std::literals;
+			Array rows;
+			for (const auto& row : matrix) {
+				Array times;
+				for (const auto& time : row) {
+					if (time) {
+						times.emplace_back(*time);
+					} else {
+						times.emplace_back(nullptr);
+					}
+				}
+				rows.emplace_back(std::move(times));
+			}
+			return Builder{}.StartDict()
+				.Key("request_id"s).Value(id)
+				.Key("total_times"s).Value(std::move(rows))
+				.EndDict().Build();
+		}
+
+		Node ParseStops(int id, const std::vector<StopDistance>& stops) {
+			using namespace std::literals;
+			Array items;
+			for (const StopDistance& item : stops) {
+				items.push_back(Builder{}.StartDict()
+					.Key("name"s).Value(item.stop->name)
+					.Key("distance"s).Value(item.distance)
+					.EndDict().Build());
+			}
+			return Builder{}.StartDict()
+				.Key("request_id"s).Value(id)
+				.Key("stops"s).Value(std::move(items))
+				.EndDict().Build();
+		}
+
+		transport_router::RouterMode ParseRouterMode(std::string_view mode) {
+			using transport_router::RouterMode;
+			if (mode == "dijkstra") {
+				return RouterMode::DIJKSTRA;
+			}
+			if (mode == "all_pairs") {
+				return RouterMode::ALL_PAIRS;
+			}
+			if (mode == "contraction_hierarchy") {
+				return RouterMode::CONTRACTION_HIERARCHY;
+			}
+			if (mode == "a_star") {
+				return RouterMode::A_STAR;
+			}
+			if (mode == "bidirectional_dijkstra") {
+				return RouterMode::BIDIRECTIONAL_DIJKSTRA;
+			}
+			if (mode == "raptor") {
+				return RouterMode::RAPTOR;
+			}
+			throw std::invalid_argument("Unknown router_mode: " + std::string(mode));
+		}
+
+		// Количество из настроек (потоки, размер кэша): отрицательное значение - ошибка входных данных,
+		// а не огромное число после приведения к size_t
+		size_t ParseCount(const Node& node, std::string_view name) {
+			const int value = node.AsInt();
+			if (value < 0) {
+				throw std::invalid_argument("Negative " + std::string(name) + ": " + std::to_string(value));
+			}
+			return static_cast<size_t>(value);
+		}
+
+		// Поток, считающий FNV-1a от всего записанного в него текста без накопления в памяти
+		class HashingBuffer : public std::streambuf {
+		public:
+			uint64_t GetHash() const {
+				return hash_;
+			}
+
+		protected:
+			int_type overflow(int_type ch) override {
+				if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+					Update(traits_type::to_char_type(ch));
+				}
+				return traits_type::not_eof(ch);
+			}
+
+			std::streamsize xsputn(const char* s, std::streamsize count) override {
+				for (std::streamsize i = 0; i < count; ++i) {
+					Update(s[i]);
+				}
+				return count;
+			}
+
+		private:
+			static constexpr uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+			static constexpr uint64_t FNV_PRIME = 1099511628211ull;
+			uint64_t hash_ = FNV_OFFSET_BASIS;
+
+			void Update(char ch) {
+				hash_ = (hash_ ^ static_cast<unsigned char>(ch)) * FNV_PRIME;
+			}
+		};
+
+		// Ключ кэша маршрутизатора: хэш событий base_requests в порядке входа
+		// и routing_settings в каноническом выводе json::PrintNode (ключи словарей упорядочены)
+		uint64_t ComputeRouterCacheKey(uint64_t base_requests_hash, const Dict& objects) {
+			HashingBuffer buffer;
+			std::ostream output(&buffer);
+			output.write(reinterpret_cast<const char*>(&base_requests_hash), sizeof(base_requests_hash));
+			PrintNode(objects.at("routing_settings"), output);
+			return buffer.GetHash();
+		}
+
+		// Разбирает события массива base_requests и передаёт запросы в CatalogueFiller.
+		// Глубина 1 - сам массив, 2 - объект запроса, 3 - его road_distances или stops.
+		// Заодно считает хэш событий для ключа кэша маршрутизатора
+		class BaseRequestsHandler : public json::Handler {
+		public:
+			explicit BaseRequestsHandler(CatalogueFiller& filler)
+				: filler_(filler) {
+			}
+
+			uint64_t GetHash() const {
+				return hash_.GetHash();
+			}
+
+			void StartMap() override {
+				HashTag('{');
+				++depth_;
+				if (depth_ == 2) {
+					request_ = {};
+				} else if (depth_ == 3) {
+					container_ = field_;
+				}
+			}
+
+			void Key(std::string_view key) override {
+				HashTag('k');
+				HashText(key);
+				if (depth_ == 2) {
+					field_ = key;
+				} else if (depth_ == 3) {
+					distance_to_ = key;
+				}
+			}
+
+			void EndMap() override {
+				HashTag('}');
+				if (depth_ == 2) {
+					Submit();
+				} else if (depth_ == 3) {
+					container_.clear();
+				}
+				--depth_;
+			}
+
+			void StartArray() override {
+				HashTag('[');
+				++depth_;
+				if (depth_ == 3) {
+					container_ = field_;
+				}
+			}
+
+			void EndArray() override {
+				HashTag(']');
+				if (depth_ == 3) {
+					container_.clear();
+				}
+				--depth_;
+			}
+
+			void Value(Node value) override {
+				HashValue(value);
+				if (depth_ == 2) {
+					SetField(std::move(value));
+				} else if (depth_ == 3 && container_ == "stops") {
+					request_.stops.emplace_back(value.AsString());
+				} else if (depth_ == 3 && container_ == "road_distances") {
+					request_.road_distances.emplace(std::move(distance_to_), static_cast<size_t>(value.AsInt()));
+				}
+			}
+
+		private:
+			// Поля запроса в том порядке, в котором они встретились во входе
+			struct Request {
+				std::string type;
+				std::string name;
+				std::optional<double> latitude;
+				std::optional<double> longitude;
+				std::optional<bool> is_roundtrip;
+				std::vector<std::string> stops;
+				std::unordered_map<std::string, size_t> road_distances;
+			};
+
+			CatalogueFiller& filler_;
+			HashingBuffer hash_;
+			int depth_ = 0;
+			Request request_;
+			std::string field_;
+			std::string container_;
+			std::string distance_to_;
+
+			void SetField(Node value) {
+				if (field_ == "type") {
+					request_.type = value.AsString();
+				} else if (field_ == "name") {
+					request_.name = value.AsString();
+				} else if (field_ == "latitude") {
+					request_.latitude = value.AsDouble();
+				} else if (field_ == "longitude") {
+					request_.longitude = value.AsDouble();
+				} else if (field_ == "is_roundtrip") {
+					request_.is_roundtrip = value.AsBool();
+				}
+			}
+
+			void Submit() {
+				if (request_.type == "Stop") {
+					if (!request_.latitude || !request_.longitude) {
+						throw std::invalid_argument("Stop without coordinates: " + request_.name);
+					}
+					filler_.AddStop({
+						.name = std::move(request_.name),
+						.pos{ .lat = *request_.latitude, .lng = *request_.longitude },
+						.road_distances = std::move(request_.road_distances)
+					});
+				} else if (request_.type == "Bus") {
+					if (!request_.is_roundtrip) {
+						throw std::invalid_argument("Bus without is_roundtrip: " + request_.name);
+					}
+					filler_.AddBus({
+						.name = std::move(request_.name),
+						.stops = std::move(request_.stops),
+						.is_roundtrip = *request_.is_roundtrip
+					});
+				}
+			}
+
+			void HashTag(char tag) {
+				hash_.sputc(tag);
+			}
+
+			void HashText(std::string_view text) {
+				const size_t size = text.size();
+				hash_.sputn(reinterpret_cast<const char*>(&size), sizeof(size));
+				hash_.sputn(text.data(), static_cast<std::streamsize>(size));
+			}
+
+			template <typename T>
+			void HashBytes(const T& value) {
+				hash_.sputn(reinterpret_cast<const char*>(&value), sizeof(value));
+			}
+
+			// Числа хэшируются двоичным представлением: форматирование в текст заметно дороже
+			void HashValue(const Node& value) {
+				if (value.IsString()) {
+					HashTag('s');
+					HashText(value.AsString());
+				} else if (value.IsInt()) {
+					HashTag('i');
+					HashBytes(value.AsInt());
+				} else if (value.IsPureDouble()) {
+					HashTag('d');
+					HashBytes(value.AsDouble());
+				} else if (value.IsBool()) {
+					HashTag(value.AsBool() ? 't' : 'f');
+				} else {
+					HashTag('n');
+				}
+			}
+		};
+
+		// Обработчик всего входа: значение ключа base_requests корневого словаря уходит
+		// в BaseRequestsHandler, остальные разделы собираются в дерево документа
+		class InputHandler : public json::Handler {
+		public:
+			explicit InputHandler(CatalogueFiller& filler)
+				: base_requests_(filler) {
+			}
+
+			void StartMap() override {
+				if (ToBaseRequests()) {
+					++base_depth_;
+					base_requests_.StartMap();
+				} else {
+					++depth_;
+					tree_.StartMap();
+				}
+			}
+
+			void Key(std::string_view key) override {
+				if (base_depth_ > 0) {
+					base_requests_.Key(key);
+				} else if (depth_ == 1 && key == "base_requests") {
+					entering_base_requests_ = true;
+				} else {
+					tree_.Key(key);
+				}
+			}
+
+			void EndMap() override {
+				if (base_depth_ > 0) {
+					--base_depth_;
+					base_requests_.EndMap();
+				} else {
+					--depth_;
+					tree_.EndMap();
+				}
+			}
+
+			void StartArray() override {
+				if (ToBaseRequests()) {
+					++base_depth_;
+					base_requests_.StartArray();
+				} else {
+					++depth_;
+					tree_.StartArray();
+				}
+			}
+
+			void EndArray() override {
+				if (base_depth_ > 0) {
+					--base_depth_;
+					base_requests_.EndArray();
+				} else {
+					--depth_;
+					tree_.EndArray();
+				}
+			}
+
+			void Value(Node value) override {
+				if (ToBaseRequests()) {
+					base_requests_.Value(std::move(value));
+				} else {
+					tree_.Value(std::move(value));
+				}
+			}
+
+			Document ExtractDocument() {
+				return tree_.Extract();
+			}
+
+			uint64_t GetBaseRequestsHash() const {
+				return base_requests_.GetHash();
+			}
+
+		private:
+			BaseRequestsHandler base_requests_;
+			json::TreeBuilder tree_;
+			int depth_ = 0;
+			int base_depth_ = 0;
+			bool entering_base_requests_ = false;
+
+			// Первое событие после ключа base_requests открывает его значение
+			bool ToBaseRequests() {
+				return std::exchange(entering_base_requests_, false) || base_depth_ > 0;
+			}
+		};
+
+		Node GetMap(const StatRequest& req, const map_renderer::Renderer& renderer) {
+			std::ostringstream ss;
+			renderer.Drawing(ss);
+			return Builder{}.StartDict()
+				.Key("request_id").Value(req.id)
+				.Key("map").Value(ss.str())
+				.EndDict().Build();
+		}
+
+		// matrix_threads - потоки RouteMatrix внутри маршрутизатора, 0 - по настройке threads
+		Node ProcessStatRequest(const StatRequest& req, const TransportCatalogue& catalogue,
+			const map_renderer::Renderer& renderer, const transport_router::TransportRouter& router, size_t matrix_threads) {
+			if (req.type == "Map") {
+				return GetMap(req, renderer);
+			}
+
+			if (req.type == "Route") {
+				auto route = router.BuildRoute(req.from, req.to);
+				return ParseRoute(req.id, route, router.GetSetting().report_stats);
+			}
+
+			if (req.type == "RouteMatrix") {
+				return ParseRouteMatrix(req.id, router.BuildMatrix(req.origins, req.destinations, matrix_threads));
+			}
+
+			if (req.type == "Nearby" || req.type == "Nearest") {
+				return ParseStops(req.id, request_handler::FindStops(req, catalogue));
+			}
+
+			Info info = request_handler::GetInfo(req, catalogue);
+			return ParseInfo(req.id, info);
+		}
+
+		svg::Color ParseColor(const Node& node) {
+			if (node.IsString()) {
+				return std::string(node.AsString());
+			}
+
+			if (node.IsArray()) {
+				const Array& arr = node.AsArray();
+				if (arr.size() == 3) {
+					return svg::Rgb(
+						static_cast<uint8_t>(arr[0].AsInt()),
+						static_cast<uint8_t>(arr[1].AsInt()),
+						static_cast<uint8_t>(arr[2].AsInt())
+					);
+				}
+				if (arr.size() == 4) {
+					return svg::Rgba(
+						static_cast<uint8_t>(arr[0].AsInt()),
+						static_cast<uint8_t>(arr[1].AsInt()),
+						static_cast<uint8_t>(arr[2].AsInt()),
+						arr[3].AsDouble()
+					);
+				}
+			}
+
+			return {};
+		}
+	} //namespace detail
+
+	// Остановки попадают в каталог по ходу разбора, без промежуточного дерева и списка запросов
+	void Reader::LoadDoc(std::istream& is, TransportCatalogue& catalogue) {
+		CatalogueFiller filler(catalogue);
+		detail::InputHandler handler(filler);
+		json::Parse(is, handler);
+		filler.Finish();
+		in_doc_ = handler.ExtractDocument();
+		base_requests_hash_ = handler.GetBaseRequestsHash();
+	}
+
+	void Reader::PrintDoc(std::ostream& os) {
+		json::Print(out_doc_, os);
+	}
+
+	// Каталог, карта и маршрутизатор при ответах только читаются, поэтому запросы независимы:
+	// потоки разбирают их из общего счётчика и пишут ответ в ячейку с номером запроса.
+	// При нескольких потоках RouteMatrix считается в потоке запроса, без вложенных потоков маршрутизатора
+	void Reader::GetData(const TransportCatalogue& catalogue, const map_renderer::Renderer& renderer, const transport_router::TransportRouter& router) {
+		std::vector<StatRequest> stat_requsetes = ParseStatRequest();
+		Array arr(stat_requsetes.size());
+		const size_t thread_count = std::min(ParseStatThreads(), stat_requsetes.size());
+		const size_t matrix_threads = thread_count > 1 ? 1 : 0;
+		std::atomic<size_t> next_request{ 0 };
+		std::exception_ptr error;
+		std::mutex error_mutex;
+		auto worker = [&] {
+			try {
+				for (size_t i = next_request++; i < stat_requsetes.size(); i = next_request++) {
+					arr[i] = detail::ProcessStatRequest(stat_requsetes[i], catalogue, renderer, router, matrix_threads);
+				}
+			} catch (...) {
+				std::lock_guard guard(error_mutex);
+				if (!error) {
+					error = std::current_exception();
+				}
+				next_request = stat_requsetes.size();
+			}
+		};
+		{
+			std::vector<std::jthread> threads;
+			for (size_t i = 1; i < thread_count; ++i) {
+				threads.emplace_back(worker);
+			}
+			worker();
+		}
+		if (error) {
+			std::rethrow_exception(error);
+		}
+
+		out_doc_ = Document{ arr };
+	}
+
+	void Reader::SetSettingRenderer(map_renderer::Renderer& renderer) {
+		renderer.SetSetting(ParseRenderSetting());
+	}
+
+	void Reader::SetSettingRouter(transport_router::TransportRouter& router) {
+		router.SetSetting(ParseRouterSetting());
+		std::vector<std::string> sources;
+		for (StatRequest& req : ParseStatRequest()) {
+			if (req.type == "Route") {
+				sources.push_back(std::move(req.from));
+			} else if (req.type == "RouteMatrix") {
+				std::ranges::move(req.origins, std::back_inserter(sources));
+			}
+		}
+		router.SetQuerySources(std::move(sources));
+	}
+
+	std::vector<StatRequest> Reader::ParseStatRequest() {
+		std::vector<StatRequest> result;
+		const Dict& objects = in_doc_.GetRoot().AsMap();
+		const Array& stat_request = objects.at("stat_requests").AsArray();
+
+		for (const Node& node : stat_request) {
+			const Dict& req = node.AsMap();
+			result.emplace_back(detail::ParseStat(req));
+		}
+		return result;
+	}
+
+	map_renderer::RenderSetting Reader::ParseRenderSetting() {
+		const Dict& objects = in_doc_.GetRoot().AsMap();
+		const Dict& settings = objects.at("render_settings").AsMap();
+		map_renderer::RenderSetting result{
+			.width = settings.at("width").AsDouble(),
+			.height = settings.at("height").AsDouble(),
+			.padding = settings.at("padding").AsDouble(),
+			.line_width = settings.at("line_width").AsDouble(),
+			.stop_radius = settings.at("stop_radius").AsDouble(),
+			.bus_label_font_size = settings.at("bus_label_font_size").AsInt(),
+			.stop_label_font_size = settings.at("stop_label_font_size").AsInt(),
+			.bus_label_offset{},
+			.stop_label_offset{},
+			.underlayer_color{},
+			.underlayer_width = settings.at("underlayer_width").AsDouble(),
+			.color_palette{}
+		};
+		const Array& bus_offset = settings.at("bus_label_offset").AsArray();
+		const Array& stop_offset = settings.at("stop_label_offset").AsArray();
+		const Node& under_layer_color = settings.at("underlayer_color");
+		const Array& color_palette = settings.at("color_palette").AsArray();
+
+		result.bus_label_offset = svg::Point{ bus_offset[0].AsDouble(), bus_offset[1].AsDouble() };
+		result.stop_label_offset = svg::Point{ stop_offset[0].AsDouble(), stop_offset[1].AsDouble() };
+		result.underlayer_color = detail::ParseColor(under_layer_color);
+
+		for (const Node& node : color_palette) {
+			result.color_palette.emplace_back(detail::ParseColor(node));
+		}
+
+		return result;
+	}
+
+	size_t Reader::ParseStatThreads() {
+		const Dict& objects = in_doc_.GetRoot().AsMap();
+		size_t result = 1;
+		if (objects.count("stat_settings")) {
+			const Dict& settings = objects.at("stat_settings").AsMap();
+			if (settings.count("threads")) {
+				result = detail::ParseCount(settings.at("threads"), "threads");
+			}
+		}
+		if (result == 0) {
+			result = std::max(1u, std::thread::hardware_concurrency());
+		}
+		return result;
+	}
+
+	transport_router::RoutingSetting Reader::ParseRouterSetting() {
+		const Dict& objects = in_doc_.GetRoot().AsMap();
+		const Dict& setting = objects.at("routing_settings").AsMap();
+		transport_router::RoutingSetting result{
+			.bus_wait = setting.at("bus_wait_time").AsInt(),
+			.bus_velocity = setting.at("bus_velocity").AsDouble()
+		};
+		if (setting.count("router_mode")) {
+			result.mode = detail::ParseRouterMode(setting.at("router_mode").AsString());
+		}
+		if (setting.count("report_stats")) {
+			result.report_stats = setting.at("report_stats").AsBool();
+		}
+		if (setting.count("threads")) {
+			result.threads = detail::ParseCount(setting.at("threads"), "threads");
+		}
+		if (setting.count("compact_table")) {
+			result.compact_table = setting.at("compact_table").AsBool();
+		}
+		if (setting.count("route_cache_size")) {
+			result.route_cache_size = detail::ParseCount(setting.at("route_cache_size"), "route_cache_size");
+		}
+		if (objects.count("serialization_settings")) {
+			result.cache_file = std::string(objects.at("serialization_settings").AsMap().at("file").AsString());
+			result.cache_key = detail::ComputeRouterCacheKey(base_requests_hash_, objects);
+		}
+		return result;
+	}
 } //namespace json_reader
\ No newline at end of file
@@ -1,40 +1,71 @@
-#pragma once
-
-#include <string>
-#include <vector>
-#include <unordered_map>
-#include <variant>
-#include <deque>
-
-#include "transport_catalogue.h"
-
-
-namespace request_handler {
-	struct StopRequest {
-		std::string name{};
-		geo::Coordinates pos{};
-		std::unordered_map<std::string, size_t> road_distances;
-	};
-
-	struct BusRequest {
-		std::string name{};
-		std::vector<std::string> stops;
-		bool is_roundtrip = false;
-	};
-
-	struct StatRequest {
-		int id = 0;
-		std::string type{};
-		std::string name{};
-
-		std::string from{};
-		std::string to{};
-	};
-
-	using InData = std::variant<std::monostate, StopRequest, BusRequest>;
-	using Info = std::variant<std::monostate, InfoStop, InfoRoute>;
-
-	void FillCatalogue(const std::deque<InData>& base_req, TransportCatalogue& catalogue);
-	Info GetInfo(const StatRequest& stat_req, const TransportCatalogue& catalogue);
-	std::vector<Route> GetRoutes(const TransportCatalogue& catalogue);
-} // namespace request_handler
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <variant>
+
+#include "transport_catalogue.h"
+
+
+namespace request_handler {
+	struct StopRequest {
+		std::string name{};
+		geo::Coordinates pos{};
+		std::unordered_map<std::string, size_t> road_distances;
+	};
+
+	struct BusRequest {
+		std::string name{};
+		std::vector<std::string> stops;
+		bool is_roundtrip = false;
+	};
+
+	struct StatRequest {
+		int id = 0;
+		std::string type{};
+		std::string name{};
+
+		std::string from{};
+		std::string to{};
+
+		std::vector<std::string> origins{};
+		std::vector<std::string> destinations{};
+
+		// Nearby: остановки в радиусе radius метров от point, Nearest: count ближайших к point
+		geo::Coordinates point{};
+		double radius = 0;
+		int count = 0;
+	};
+
+	using Info = std::variant<std::monostate, InfoStop, InfoRoute>;
+
+	// Заполняет каталог по мере разбора base_requests. Остановка попадает в каталог сразу,
+	// а маршруты и расстояния могут ссылаться на остановки дальше во входе,
+	// поэтому откладываются до Finish
+	class CatalogueFiller {
+	public:
+		explicit CatalogueFiller(TransportCatalogue& catalogue);
+
+		void AddStop(StopRequest&& req);
+		void AddBus(BusRequest&& req);
+		// Добавляет отложенные маршруты и расстояния и вызывает Finalize каталога
+		void Finish();
+
+	private:
+		struct PendingDistance {
+			StopId from = 0;
+			std::string to;
+			size_t distance = 0;
+		};
+
+		TransportCatalogue& catalogue_;
+		std::vector<BusRequest> buses_;
+		std::vector<PendingDistance> distances_;
+	};
+
+	Info GetInfo(const StatRequest& stat_req, const TransportCatalogue& catalogue);
+	// Ответ на запросы Nearby и Nearest
+	std::vector<StopDistance> FindStops(const StatRequest& stat_req, const TransportCatalogue& catalogue);
+	std::vector<Route> GetRoutes(const TransportCatalogue& catalogue);
+} // namespace request_handler
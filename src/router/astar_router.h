@@ -0,0 +1,119 @@
+#pragma once
+
+#include "router.h"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+// Поиск A*: Дейкстра, в которой вершины упорядочены по сумме найденного веса и
+// нижней оценки оставшегося пути. Оценка heuristic(vertex, to) обязана не превышать
+// настоящий вес кратчайшего пути vertex -> to и быть согласованной:
+// heuristic(u, to) <= weight(u -> v) + heuristic(v, to). Тогда ответ совпадает с Дейкстрой,
+// а поиск просматривает только «коридор» между начальной и конечной вершинами
+template <typename Weight>
+class AStarRouter : public RouterBase<Weight> {
+private:
+    using Graph = DirectedWeightedGraph<Weight>;
+
+public:
+    using typename RouterBase<Weight>::RouteInfo;
+    using Heuristic = std::function<Weight(VertexId vertex, VertexId to)>;
+
+    AStarRouter(const Graph& graph, Heuristic heuristic);
+
+    std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to) const override;
+
+private:
+    static constexpr EdgeId NO_EDGE = std::numeric_limits<EdgeId>::max();
+    static constexpr Weight ZERO_WEIGHT{};
+
+    struct VertexState {
+        Weight weight{};
+        EdgeId prev_edge = NO_EDGE;
+        bool reached = false;
+        bool settled = false;
+    };
+
+    // Элемент кучи: {вес + оценка, вершина}
+    using QueueItem = std::pair<Weight, VertexId>;
+    using Queue = std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>>;
+
+    const Graph& graph_;
+    Heuristic heuristic_;
+};
+
+template <typename Weight>
+AStarRouter<Weight>::AStarRouter(const Graph& graph, Heuristic heuristic)
+    : graph_(graph)
+    , heuristic_(std::move(heuristic))
+{
+    for (EdgeId edge_id = 0; edge_id < graph.GetEdgeCount(); ++edge_id) {
+        if (graph.GetEdge(edge_id).weight < ZERO_WEIGHT) {
+            throw std::domain_error("Edges' weights should be non-negative");
+        }
+    }
+}
+
+template <typename Weight>
+std::optional<typename AStarRouter<Weight>::RouteInfo> AStarRouter<Weight>::BuildRoute(VertexId from,
+                                                                                       VertexId to) const {
+    const size_t vertex_count = graph_.GetVertexCount();
+    if (from >= vertex_count || to >= vertex_count) {
+        throw std::out_of_range("Vertex is out of range");
+    }
+
+    std::vector<VertexState> states(vertex_count);
+    Queue queue;
+    SearchStats stats;
+    states[from] = VertexState{ZERO_WEIGHT, NO_EDGE, true, false};
+    queue.emplace(heuristic_(from, to), from);
+
+    while (!queue.empty()) {
+        const VertexId vertex = queue.top().second;
+        queue.pop();
+        VertexState& current = states[vertex];
+        if (current.settled) {
+            continue;
+        }
+        current.settled = true;
+        ++stats.settled_vertices;
+        if (vertex == to) {
+            break;
+        }
+
+        const Weight weight = current.weight;
+        graph_.ForEachIncidentEdge(vertex, [&](EdgeId edge_id, VertexId edge_to, Weight edge_weight) {
+            ++stats.relaxed_edges;
+            const Weight candidate_weight = weight + edge_weight;
+            VertexState& state = states[edge_to];
+            if (!state.settled && (!state.reached || candidate_weight < state.weight)) {
+                state = VertexState{candidate_weight, edge_id, true, false};
+                queue.emplace(candidate_weight + heuristic_(edge_to, to), edge_to);
+            }
+        });
+    }
+
+    if (!states[to].reached) {
+        return std::nullopt;
+    }
+
+    std::vector<EdgeId> edges;
+    for (EdgeId edge_id = states[to].prev_edge; edge_id != NO_EDGE;
+         edge_id = states[graph_.GetEdge(edge_id).from].prev_edge)
+    {
+        edges.push_back(edge_id);
+    }
+    std::reverse(edges.begin(), edges.end());
+
+    return RouteInfo{states[to].weight, std::move(edges), stats};
+}
+
+}  // namespace graph
@@ -0,0 +1,169 @@
+#pragma once
+
+#include "router.h"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+// Двунаправленный поиск Дейкстры: прямой поиск из начальной вершины по исходящим рёбрам
+// и обратный из конечной по входящим рёбрам (обратное CSR-представление графа).
+// На каждом шаге продвигается сторона с меньшим ключом на вершине кучи. Каждое ребро,
+// соединяющее две достигнутые области, даёт кандидата на ответ; поиск останавливается,
+// когда сумма ключей обеих куч не меньше лучшего кандидата: более короткий путь
+// обязан был бы пройти через неизвлечённые вершины обеих сторон.
+// Требует графа после Freeze
+template <typename Weight>
+class BidirectionalDijkstraRouter : public RouterBase<Weight> {
+private:
+    using Graph = DirectedWeightedGraph<Weight>;
+
+public:
+    using typename RouterBase<Weight>::RouteInfo;
+
+    explicit BidirectionalDijkstraRouter(const Graph& graph);
+
+    std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to) const override;
+
+private:
+    static constexpr EdgeId NO_EDGE = std::numeric_limits<EdgeId>::max();
+    static constexpr Weight ZERO_WEIGHT{};
+
+    // edge - последнее ребро пути для прямого поиска и первое для обратного
+    struct VertexState {
+        Weight weight{};
+        EdgeId edge = NO_EDGE;
+        bool reached = false;
+    };
+
+    using QueueItem = std::pair<Weight, VertexId>;
+    using Queue = std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>>;
+
+    // Лучший найденный путь: прямой путь до from_vertex, ребро edge, обратный путь от to_vertex
+    struct Meeting {
+        Weight weight{};
+        VertexId from_vertex = 0;
+        EdgeId edge = NO_EDGE;
+        VertexId to_vertex = 0;
+    };
+
+    const Graph& graph_;
+};
+
+template <typename Weight>
+BidirectionalDijkstraRouter<Weight>::BidirectionalDijkstraRouter(const Graph& graph)
+    : graph_(graph)
+{
+    if (!graph.IsFrozen()) {
+        throw std::logic_error("Bidirectional search requires a frozen graph");
+    }
+    for (EdgeId edge_id = 0; edge_id < graph.GetEdgeCount(); ++edge_id) {
+        if (graph.GetEdge(edge_id).weight < ZERO_WEIGHT) {
+            throw std::domain_error("Edges' weights should be non-negative");
+        }
+    }
+}
+
+template <typename Weight>
+std::optional<typename BidirectionalDijkstraRouter<Weight>::RouteInfo>
+BidirectionalDijkstraRouter<Weight>::BuildRoute(VertexId from, VertexId to) const {
+    const size_t vertex_count = graph_.GetVertexCount();
+    if (from >= vertex_count || to >= vertex_count) {
+        throw std::out_of_range("Vertex is out of range");
+    }
+
+    std::vector<VertexState> forward(vertex_count);
+    std::vector<VertexState> backward(vertex_count);
+    Queue forward_queue;
+    Queue backward_queue;
+    SearchStats stats;
+    std::optional<Meeting> best;
+
+    forward[from] = VertexState{ZERO_WEIGHT, NO_EDGE, true};
+    backward[to] = VertexState{ZERO_WEIGHT, NO_EDGE, true};
+    forward_queue.emplace(ZERO_WEIGHT, from);
+    backward_queue.emplace(ZERO_WEIGHT, to);
+    if (from == to) {
+        best = Meeting{ZERO_WEIGHT, from, NO_EDGE, to};
+    }
+
+    auto update_best = [&best](Weight weight, VertexId from_vertex, EdgeId edge_id, VertexId to_vertex) {
+        if (!best || weight < best->weight) {
+            best = Meeting{weight, from_vertex, edge_id, to_vertex};
+        }
+    };
+
+    // Пустая куча означает, что одна из сторон исчерпала достижимые вершины: все пути
+    // между областями уже просмотрены
+    while (!forward_queue.empty() && !backward_queue.empty()) {
+        if (best && !(forward_queue.top().first + backward_queue.top().first < best->weight)) {
+            break;
+        }
+        const bool is_forward = !(backward_queue.top().first < forward_queue.top().first);
+        Queue& queue = is_forward ? forward_queue : backward_queue;
+        std::vector<VertexState>& states = is_forward ? forward : backward;
+        const auto [weight, vertex] = queue.top();
+        queue.pop();
+        if (states[vertex].weight < weight) {
+            continue;
+        }
+        ++stats.settled_vertices;
+
+        auto relax = [&, weight = weight](EdgeId edge_id, VertexId next, Weight edge_weight) {
+            ++stats.relaxed_edges;
+            const Weight candidate_weight = weight + edge_weight;
+            VertexState& state = states[next];
+            if (!state.reached || candidate_weight < state.weight) {
+                state = VertexState{candidate_weight, edge_id, true};
+                queue.emplace(candidate_weight, next);
+            }
+        };
+
+        if (is_forward) {
+            graph_.ForEachIncidentEdge(vertex, [&](EdgeId edge_id, VertexId edge_to, Weight edge_weight) {
+                relax(edge_id, edge_to, edge_weight);
+                if (backward[edge_to].reached) {
+                    update_best(weight + edge_weight + backward[edge_to].weight, vertex, edge_id, edge_to);
+                }
+            });
+        } else {
+            graph_.ForEachIncomingEdge(vertex, [&](EdgeId edge_id, VertexId edge_from, Weight edge_weight) {
+                relax(edge_id, edge_from, edge_weight);
+                if (forward[edge_from].reached) {
+                    update_best(forward[edge_from].weight + edge_weight + weight, edge_from, edge_id, vertex);
+                }
+            });
+        }
+    }
+
+    if (!best) {
+        return std::nullopt;
+    }
+
+    std::vector<EdgeId> edges;
+    for (EdgeId edge_id = forward[best->from_vertex].edge; edge_id != NO_EDGE;
+         edge_id = forward[graph_.GetEdge(edge_id).from].edge)
+    {
+        edges.push_back(edge_id);
+    }
+    std::reverse(edges.begin(), edges.end());
+    if (best->edge != NO_EDGE) {
+        edges.push_back(best->edge);
+    }
+    for (EdgeId edge_id = backward[best->to_vertex].edge; edge_id != NO_EDGE;
+         edge_id = backward[graph_.GetEdge(edge_id).to].edge)
+    {
+        edges.push_back(edge_id);
+    }
+
+    return RouteInfo{best->weight, std::move(edges), stats};
+}
+
+}  // namespace graph
@@ -0,0 +1,456 @@
+#pragma once
+
+#include "router.h"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+// Иерархия сжатия (contraction hierarchy).
+// При построении вершины по очереди «сжимаются»: пути через сжимаемую вершину
+// заменяются ярлыками (shortcut), если между её соседями нет пути-свидетеля не длиннее.
+// Запрос выполняет двунаправленный поиск только по рёбрам, ведущим к более поздним
+// по порядку сжатия вершинам, а затем разворачивает ярлыки в исходные рёбра графа
+template <typename Weight>
+class ContractionHierarchy : public RouterBase<Weight> {
+private:
+    using Graph = DirectedWeightedGraph<Weight>;
+
+public:
+    using typename RouterBase<Weight>::RouteInfo;
+
+    explicit ContractionHierarchy(const Graph& graph);
+
+    std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to) const override;
+
+    size_t GetShortcutCount() const;
+
+private:
+    static constexpr size_t NONE = std::numeric_limits<size_t>::max();
+    static constexpr Weight ZERO_WEIGHT{};
+    // Ограничение числа вершин, извлекаемых при поиске свидетеля.
+    // Если свидетель не найден в пределах лимита, ярлык добавляется с запасом
+    static constexpr size_t WITNESS_SETTLE_LIMIT = 100;
+
+    // Ребро иерархии: либо исходное ребро графа, либо ярлык из двух рёбер иерархии
+    struct HierarchyEdge {
+        VertexId from;
+        VertexId to;
+        Weight weight;
+        EdgeId original = NONE;
+        size_t first = NONE;
+        size_t second = NONE;
+    };
+
+    // Ребро поиска «вверх» по иерархии
+    struct UpwardEdge {
+        VertexId target;
+        Weight weight;
+        size_t hierarchy_edge;
+    };
+
+    struct Arc {
+        VertexId vertex;
+        size_t hierarchy_edge;
+    };
+
+    struct Shortcut {
+        VertexId from;
+        VertexId to;
+        Weight weight;
+        size_t first;
+        size_t second;
+    };
+
+    struct SearchState {
+        Weight weight{};
+        size_t parent = NONE;
+        bool reached = false;
+    };
+
+    using QueueItem = std::pair<Weight, VertexId>;
+    using Queue = std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>>;
+
+    // Состояние построения иерархии, существует только в конструкторе
+    class Contractor {
+    public:
+        Contractor(const Graph& graph, std::vector<HierarchyEdge>& hierarchy_edges);
+
+        void Run(std::vector<std::vector<UpwardEdge>>& forward, std::vector<std::vector<UpwardEdge>>& backward);
+
+    private:
+        std::vector<HierarchyEdge>& hierarchy_edges_;
+        std::vector<std::vector<Arc>> out_;
+        std::vector<std::vector<Arc>> in_;
+        std::vector<int> deleted_neighbors_;
+
+        std::vector<Weight> witness_weights_;
+        std::vector<bool> witness_reached_;
+        std::vector<VertexId> witness_touched_;
+        std::vector<bool> witness_targets_;
+        std::vector<Weight> target_weights_;
+
+        Weight GetWeight(const Arc& arc) const {
+            return hierarchy_edges_[arc.hierarchy_edge].weight;
+        }
+
+        void AddArc(VertexId from, VertexId to, Weight weight, EdgeId original, size_t first, size_t second);
+        void RunWitnessSearch(VertexId source, VertexId skipped, Weight limit, size_t target_count);
+        std::vector<Shortcut> FindShortcuts(VertexId vertex);
+        long long GetPriority(VertexId vertex, const std::vector<Shortcut>& shortcuts) const;
+        void Contract(VertexId vertex, const std::vector<Shortcut>& shortcuts,
+                      std::vector<UpwardEdge>& forward, std::vector<UpwardEdge>& backward);
+        static void EraseArc(std::vector<Arc>& arcs, VertexId vertex);
+    };
+
+    void Unpack(size_t hierarchy_edge, std::vector<EdgeId>& edges) const;
+
+    std::vector<HierarchyEdge> hierarchy_edges_;
+    // Поиск вверх в CSR-виде: рёбра вершины v лежат в [offsets[v], offsets[v + 1])
+    std::vector<size_t> forward_offsets_;
+    std::vector<UpwardEdge> forward_edges_;
+    std::vector<size_t> backward_offsets_;
+    std::vector<UpwardEdge> backward_edges_;
+    size_t shortcut_count_ = 0;
+};
+
+//-----Contractor-----
+
+template <typename Weight>
+ContractionHierarchy<Weight>::Contractor::Contractor(const Graph& graph, std::vector<HierarchyEdge>& hierarchy_edges)
+    : hierarchy_edges_(hierarchy_edges)
+    , out_(graph.GetVertexCount())
+    , in_(graph.GetVertexCount())
+    , deleted_neighbors_(graph.GetVertexCount(), 0)
+    , witness_weights_(graph.GetVertexCount())
+    , witness_reached_(graph.GetVertexCount(), false)
+    , witness_targets_(graph.GetVertexCount(), false)
+    , target_weights_(graph.GetVertexCount())
+{
+    for (EdgeId edge_id = 0; edge_id < graph.GetEdgeCount(); ++edge_id) {
+        const auto& edge = graph.GetEdge(edge_id);
+        if (edge.weight < ZERO_WEIGHT) {
+            throw std::domain_error("Edges' weights should be non-negative");
+        }
+        if (edge.from != edge.to) {
+            AddArc(edge.from, edge.to, edge.weight, edge_id, NONE, NONE);
+        }
+    }
+}
+
+// Добавляет дугу from -> to или уменьшает вес существующей (из параллельных рёбер остаётся легчайшее)
+template <typename Weight>
+void ContractionHierarchy<Weight>::Contractor::AddArc(VertexId from, VertexId to, Weight weight,
+                                                      EdgeId original, size_t first, size_t second) {
+    auto it = std::find_if(out_[from].begin(), out_[from].end(), [to](const Arc& arc) { return arc.vertex == to; });
+    if (it != out_[from].end() && !(weight < GetWeight(*it))) {
+        return;
+    }
+
+    hierarchy_edges_.push_back(HierarchyEdge{from, to, weight, original, first, second});
+    const size_t id = hierarchy_edges_.size() - 1;
+    if (it != out_[from].end()) {
+        it->hierarchy_edge = id;
+        for (Arc& arc : in_[to]) {
+            if (arc.vertex == from) {
+                arc.hierarchy_edge = id;
+            }
+        }
+        return;
+    }
+    out_[from].push_back(Arc{to, id});
+    in_[to].push_back(Arc{from, id});
+}
+
+// Поиск Дейкстры из source в оставшемся графе без вершины skipped, не дальше limit.
+// Завершается досрочно, когда извлечены все target_count помеченных целей
+template <typename Weight>
+void ContractionHierarchy<Weight>::Contractor::RunWitnessSearch(VertexId source, VertexId skipped, Weight limit,
+                                                                size_t target_count) {
+    for (const VertexId vertex : witness_touched_) {
+        witness_reached_[vertex] = false;
+    }
+    witness_touched_.clear();
+
+    Queue queue;
+    witness_weights_[source] = ZERO_WEIGHT;
+    witness_reached_[source] = true;
+    witness_touched_.push_back(source);
+    queue.emplace(ZERO_WEIGHT, source);
+
+    size_t settled = 0;
+    while (!queue.empty() && settled < WITNESS_SETTLE_LIMIT) {
+        const auto [weight, vertex] = queue.top();
+        queue.pop();
+        if (witness_weights_[vertex] < weight) {
+            continue;
+        }
+        if (witness_targets_[vertex] && --target_count == 0) {
+            break;
+        }
+        ++settled;
+        for (const Arc& arc : out_[vertex]) {
+            if (arc.vertex == skipped) {
+                continue;
+            }
+            const Weight candidate_weight = weight + GetWeight(arc);
+            if (limit < candidate_weight) {
+                continue;
+            }
+            if (!witness_reached_[arc.vertex] || candidate_weight < witness_weights_[arc.vertex]) {
+                if (!witness_reached_[arc.vertex]) {
+                    witness_reached_[arc.vertex] = true;
+                    witness_touched_.push_back(arc.vertex);
+                }
+                witness_weights_[arc.vertex] = candidate_weight;
+                queue.emplace(candidate_weight, arc.vertex);
+            }
+        }
+    }
+}
+
+template <typename Weight>
+std::vector<typename ContractionHierarchy<Weight>::Shortcut>
+ContractionHierarchy<Weight>::Contractor::FindShortcuts(VertexId vertex) {
+    std::vector<Shortcut> shortcuts;
+    std::vector<Shortcut> candidates;
+    for (const Arc& in_arc : in_[vertex]) {
+        const VertexId source = in_arc.vertex;
+        candidates.clear();
+        for (const Arc& out_arc : out_[vertex]) {
+            if (out_arc.vertex != source) {
+                candidates.push_back(Shortcut{source, out_arc.vertex, GetWeight(in_arc) + GetWeight(out_arc),
+                                              in_arc.hierarchy_edge, out_arc.hierarchy_edge});
+                witness_targets_[out_arc.vertex] = true;
+                target_weights_[out_arc.vertex] = candidates.back().weight;
+            }
+        }
+
+        // Свидетель из одного ребра: прямое ребро source -> target не тяжелее пути через vertex
+        for (const Arc& arc : out_[source]) {
+            if (witness_targets_[arc.vertex] && !(target_weights_[arc.vertex] < GetWeight(arc))) {
+                witness_targets_[arc.vertex] = false;
+            }
+        }
+
+        // Если в цель ведёт только ребро из сжимаемой вершины, свидетеля заведомо нет и поиск не нужен
+        std::optional<Weight> limit;
+        size_t target_count = 0;
+        for (const Shortcut& candidate : candidates) {
+            if (witness_targets_[candidate.to] && in_[candidate.to].size() > 1) {
+                ++target_count;
+                if (!limit || *limit < candidate.weight) {
+                    limit = candidate.weight;
+                }
+            }
+        }
+        if (limit) {
+            RunWitnessSearch(source, vertex, *limit, target_count);
+        }
+
+        for (const Shortcut& candidate : candidates) {
+            if (!witness_targets_[candidate.to]) {
+                continue;
+            }
+            witness_targets_[candidate.to] = false;
+            const bool has_witness = in_[candidate.to].size() > 1 && witness_reached_[candidate.to]
+                && !(candidate.weight < witness_weights_[candidate.to]);
+            if (!has_witness) {
+                shortcuts.push_back(candidate);
+            }
+        }
+    }
+    return shortcuts;
+}
+
+// Разность рёбер: сколько ярлыков добавится минус сколько рёбер исчезнет,
+// плюс число уже сжатых соседей для равномерного сжатия по графу
+template <typename Weight>
+long long ContractionHierarchy<Weight>::Contractor::GetPriority(VertexId vertex,
+                                                                const std::vector<Shortcut>& shortcuts) const {
+    const auto shortcut_count = static_cast<long long>(shortcuts.size());
+    const auto removed_count = static_cast<long long>(in_[vertex].size() + out_[vertex].size());
+    return shortcut_count - removed_count + deleted_neighbors_[vertex];
+}
+
+template <typename Weight>
+void ContractionHierarchy<Weight>::Contractor::EraseArc(std::vector<Arc>& arcs, VertexId vertex) {
+    arcs.erase(std::remove_if(arcs.begin(), arcs.end(), [vertex](const Arc& arc) { return arc.vertex == vertex; }),
+               arcs.end());
+}
+
+template <typename Weight>
+void ContractionHierarchy<Weight>::Contractor::Contract(VertexId vertex, const std::vector<Shortcut>& shortcuts,
+                                                        std::vector<UpwardEdge>& forward,
+                                                        std::vector<UpwardEdge>& backward) {
+    // Все оставшиеся соседи сжимаются позже, поэтому рёбра к ним ведут вверх по иерархии
+    for (const Arc& arc : out_[vertex]) {
+        forward.push_back(UpwardEdge{arc.vertex, GetWeight(arc), arc.hierarchy_edge});
+        EraseArc(in_[arc.vertex], vertex);
+        ++deleted_neighbors_[arc.vertex];
+    }
+    for (const Arc& arc : in_[vertex]) {
+        backward.push_back(UpwardEdge{arc.vertex, GetWeight(arc), arc.hierarchy_edge});
+        EraseArc(out_[arc.vertex], vertex);
+        ++deleted_neighbors_[arc.vertex];
+    }
+    out_[vertex].clear();
+    in_[vertex].clear();
+
+    for (const Shortcut& shortcut : shortcuts) {
+        AddArc(shortcut.from, shortcut.to, shortcut.weight, NONE, shortcut.first, shortcut.second);
+    }
+}
+
+template <typename Weight>
+void ContractionHierarchy<Weight>::Contractor::Run(std::vector<std::vector<UpwardEdge>>& forward,
+                                                   std::vector<std::vector<UpwardEdge>>& backward) {
+    using PriorityItem = std::pair<long long, VertexId>;
+    std::priority_queue<PriorityItem, std::vector<PriorityItem>, std::greater<PriorityItem>> order;
+    for (VertexId vertex = 0; vertex < out_.size(); ++vertex) {
+        order.emplace(GetPriority(vertex, FindShortcuts(vertex)), vertex);
+    }
+
+    // Ленивое обновление: приоритет пересчитывается при извлечении,
+    // и вершина возвращается в очередь, если перестала быть минимальной
+    while (!order.empty()) {
+        const VertexId vertex = order.top().second;
+        order.pop();
+        const std::vector<Shortcut> shortcuts = FindShortcuts(vertex);
+        const long long priority = GetPriority(vertex, shortcuts);
+        if (!order.empty() && order.top().first < priority) {
+            order.emplace(priority, vertex);
+            continue;
+        }
+        Contract(vertex, shortcuts, forward[vertex], backward[vertex]);
+    }
+}
+
+//-----ContractionHierarchy-----
+
+template <typename Weight>
+ContractionHierarchy<Weight>::ContractionHierarchy(const Graph& graph) {
+    const size_t vertex_count = graph.GetVertexCount();
+    std::vector<std::vector<UpwardEdge>> forward(vertex_count);
+    std::vector<std::vector<UpwardEdge>> backward(vertex_count);
+    Contractor(graph, hierarchy_edges_).Run(forward, backward);
+
+    shortcut_count_ = static_cast<size_t>(std::count_if(hierarchy_edges_.begin(), hierarchy_edges_.end(),
+                                    [](const HierarchyEdge& edge) { return edge.original == NONE; }));
+
+    auto pack = [vertex_count](std::vector<std::vector<UpwardEdge>>& lists, std::vector<size_t>& offsets,
+                               std::vector<UpwardEdge>& edges) {
+        offsets.assign(vertex_count + 1, 0);
+        for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+            edges.insert(edges.end(), lists[vertex].begin(), lists[vertex].end());
+            offsets[vertex + 1] = edges.size();
+            std::vector<UpwardEdge>{}.swap(lists[vertex]);
+        }
+    };
+    pack(forward, forward_offsets_, forward_edges_);
+    pack(backward, backward_offsets_, backward_edges_);
+}
+
+template <typename Weight>
+size_t ContractionHierarchy<Weight>::GetShortcutCount() const {
+    return shortcut_count_;
+}
+
+template <typename Weight>
+std::optional<typename ContractionHierarchy<Weight>::RouteInfo>
+ContractionHierarchy<Weight>::BuildRoute(VertexId from, VertexId to) const {
+    const size_t vertex_count = forward_offsets_.size() - 1;
+    if (from >= vertex_count || to >= vertex_count) {
+        throw std::out_of_range("Vertex is out of range");
+    }
+
+    // Индекс 0 - прямой поиск от from, индекс 1 - обратный поиск от to
+    std::vector<SearchState> states[2] = {std::vector<SearchState>(vertex_count),
+                                          std::vector<SearchState>(vertex_count)};
+    const std::vector<size_t>* offsets[2] = {&forward_offsets_, &backward_offsets_};
+    const std::vector<UpwardEdge>* edges[2] = {&forward_edges_, &backward_edges_};
+    Queue queues[2];
+    states[0][from] = SearchState{ZERO_WEIGHT, NONE, true};
+    states[1][to] = SearchState{ZERO_WEIGHT, NONE, true};
+    queues[0].emplace(ZERO_WEIGHT, from);
+    queues[1].emplace(ZERO_WEIGHT, to);
+
+    std::optional<Weight> best_weight;
+    VertexId meeting_vertex = from;
+    auto is_active = [&](int side) {
+        return !queues[side].empty() && (!best_weight || queues[side].top().first < *best_weight);
+    };
+
+    // Каждое направление останавливается, когда его минимальный ключ не меньше лучшего найденного пути
+    while (is_active(0) || is_active(1)) {
+        const int side = !is_active(0) ? 1 : !is_active(1) ? 0
+            : (queues[1].top().first < queues[0].top().first ? 1 : 0);
+        const auto [weight, vertex] = queues[side].top();
+        queues[side].pop();
+        if (states[side][vertex].weight < weight) {
+            continue;
+        }
+
+        const SearchState& opposite = states[1 - side][vertex];
+        if (opposite.reached && (!best_weight || weight + opposite.weight < *best_weight)) {
+            best_weight = weight + opposite.weight;
+            meeting_vertex = vertex;
+        }
+
+        for (size_t i = (*offsets[side])[vertex]; i < (*offsets[side])[vertex + 1]; ++i) {
+            const UpwardEdge& edge = (*edges[side])[i];
+            const Weight candidate_weight = weight + edge.weight;
+            SearchState& state = states[side][edge.target];
+            if (!state.reached || candidate_weight < state.weight) {
+                state = SearchState{candidate_weight, edge.hierarchy_edge, true};
+                queues[side].emplace(candidate_weight, edge.target);
+            }
+        }
+    }
+
+    if (!best_weight) {
+        return std::nullopt;
+    }
+
+    std::vector<size_t> path;
+    for (size_t edge = states[0][meeting_vertex].parent; edge != NONE;
+         edge = states[0][hierarchy_edges_[edge].from].parent) {
+        path.push_back(edge);
+    }
+    std::reverse(path.begin(), path.end());
+    for (size_t edge = states[1][meeting_vertex].parent; edge != NONE;
+         edge = states[1][hierarchy_edges_[edge].to].parent) {
+        path.push_back(edge);
+    }
+
+    std::vector<EdgeId> result;
+    for (const size_t edge : path) {
+        Unpack(edge, result);
+    }
+    return RouteInfo{*best_weight, std::move(result)};
+}
+
+// Разворачивает ярлык в последовательность исходных рёбер графа
+template <typename Weight>
+void ContractionHierarchy<Weight>::Unpack(size_t hierarchy_edge, std::vector<EdgeId>& edges) const {
+    std::vector<size_t> stack{hierarchy_edge};
+    while (!stack.empty()) {
+        const HierarchyEdge& edge = hierarchy_edges_[stack.back()];
+        stack.pop_back();
+        if (edge.original != NONE) {
+            edges.push_back(edge.original);
+            continue;
+        }
+        stack.push_back(edge.second);
+        stack.push_back(edge.first);
+    }
+}
+
+}  // namespace graph
@@ -0,0 +1,165 @@
+#pragma once
+
+#include "router.h"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <queue>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+// Поиск кратчайшего пути алгоритмом Дейкстры в момент запроса.
+// Предрасчёт отсутствует: построение за O(E), память O(V + E),
+// запрос за O((V + E) log V) с остановкой после извлечения целевой вершины
+template <typename Weight>
+class DijkstraRouter : public RouterBase<Weight> {
+private:
+    using Graph = DirectedWeightedGraph<Weight>;
+
+public:
+    using typename RouterBase<Weight>::RouteInfo;
+
+    explicit DijkstraRouter(const Graph& graph);
+
+    std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to) const override;
+
+    // Один поиск из from, который останавливается после извлечения всех целей
+    std::vector<std::optional<Weight>> BuildWeights(VertexId from, std::span<const VertexId> targets) const override;
+
+private:
+    static constexpr EdgeId NO_EDGE = std::numeric_limits<EdgeId>::max();
+    static constexpr Weight ZERO_WEIGHT{};
+
+    struct VertexState {
+        Weight weight{};
+        EdgeId prev_edge = NO_EDGE;
+        bool reached = false;
+    };
+
+    // Элемент двоичной кучи: {вес, вершина}, минимальный вес на вершине кучи
+    using QueueItem = std::pair<Weight, VertexId>;
+    using Queue = std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>>;
+
+    const Graph& graph_;
+};
+
+template <typename Weight>
+DijkstraRouter<Weight>::DijkstraRouter(const Graph& graph)
+    : graph_(graph)
+{
+    for (EdgeId edge_id = 0; edge_id < graph.GetEdgeCount(); ++edge_id) {
+        if (graph.GetEdge(edge_id).weight < ZERO_WEIGHT) {
+            throw std::domain_error("Edges' weights should be non-negative");
+        }
+    }
+}
+
+template <typename Weight>
+std::optional<typename DijkstraRouter<Weight>::RouteInfo> DijkstraRouter<Weight>::BuildRoute(VertexId from,
+                                                                                             VertexId to) const {
+    const size_t vertex_count = graph_.GetVertexCount();
+    if (from >= vertex_count || to >= vertex_count) {
+        throw std::out_of_range("Vertex is out of range");
+    }
+
+    // Состояние поиска локально для запроса, поэтому BuildRoute можно вызывать из разных потоков
+    std::vector<VertexState> states(vertex_count);
+    Queue queue;
+    SearchStats stats;
+    states[from] = VertexState{ZERO_WEIGHT, NO_EDGE, true};
+    queue.emplace(ZERO_WEIGHT, from);
+
+    while (!queue.empty()) {
+        const auto [weight, vertex] = queue.top();
+        queue.pop();
+        // Устаревшая запись: вершина уже извлекалась с меньшим весом
+        if (states[vertex].weight < weight) {
+            continue;
+        }
+        ++stats.settled_vertices;
+        if (vertex == to) {
+            break;
+        }
+        graph_.ForEachIncidentEdge(vertex, [&, weight = weight](EdgeId edge_id, VertexId edge_to, Weight edge_weight) {
+            ++stats.relaxed_edges;
+            const Weight candidate_weight = weight + edge_weight;
+            VertexState& state = states[edge_to];
+            if (!state.reached || candidate_weight < state.weight) {
+                state = VertexState{candidate_weight, edge_id, true};
+                queue.emplace(candidate_weight, edge_to);
+            }
+        });
+    }
+
+    if (!states[to].reached) {
+        return std::nullopt;
+    }
+
+    std::vector<EdgeId> edges;
+    for (EdgeId edge_id = states[to].prev_edge; edge_id != NO_EDGE;
+         edge_id = states[graph_.GetEdge(edge_id).from].prev_edge)
+    {
+        edges.push_back(edge_id);
+    }
+    std::reverse(edges.begin(), edges.end());
+
+    return RouteInfo{states[to].weight, std::move(edges), stats};
+}
+
+template <typename Weight>
+std::vector<std::optional<Weight>> DijkstraRouter<Weight>::BuildWeights(VertexId from,
+                                                                        std::span<const VertexId> targets) const {
+    const size_t vertex_count = graph_.GetVertexCount();
+    if (from >= vertex_count || std::ranges::any_of(targets, [vertex_count](VertexId to) { return to >= vertex_count; })) {
+        throw std::out_of_range("Vertex is out of range");
+    }
+
+    std::vector<bool> is_target(vertex_count, false);
+    size_t remaining = 0;
+    for (const VertexId to : targets) {
+        if (!is_target[to]) {
+            is_target[to] = true;
+            ++remaining;
+        }
+    }
+
+    std::vector<VertexState> states(vertex_count);
+    Queue queue;
+    states[from] = VertexState{ZERO_WEIGHT, NO_EDGE, true};
+    queue.emplace(ZERO_WEIGHT, from);
+
+    while (!queue.empty() && remaining > 0) {
+        const auto [weight, vertex] = queue.top();
+        queue.pop();
+        if (states[vertex].weight < weight) {
+            continue;
+        }
+        if (is_target[vertex]) {
+            is_target[vertex] = false;
+            --remaining;
+        }
+        graph_.ForEachIncidentEdge(vertex, [&, weight = weight](EdgeId edge_id, VertexId edge_to, Weight edge_weight) {
+            const Weight candidate_weight = weight + edge_weight;
+            VertexState& state = states[edge_to];
+            if (!state.reached || candidate_weight < state.weight) {
+                state = VertexState{candidate_weight, edge_id, true};
+                queue.emplace(candidate_weight, edge_to);
+            }
+        });
+    }
+
+    std::vector<std::optional<Weight>> result;
+    result.reserve(targets.size());
+    for (const VertexId to : targets) {
+        result.push_back(states[to].reached ? std::optional<Weight>(states[to].weight) : std::nullopt);
+    }
+    return result;
+}
+
+}  // namespace graph
@@ -1,74 +1,184 @@
-#pragma once
-
-#include "ranges.h"
-
-#include <cstdlib>
-#include <vector>
-
-namespace graph {
-
-using VertexId = size_t;
-using EdgeId = size_t;
-
-template <typename Weight>
-struct Edge {
-    VertexId from;
-    VertexId to;
-    Weight weight;
-};
-
-template <typename Weight>
-class DirectedWeightedGraph {
-private:
-    using IncidenceList = std::vector<EdgeId>;
-    using IncidentEdgesRange = ranges::Range<typename IncidenceList::const_iterator>;
-
-public:
-    DirectedWeightedGraph() = default;
-    explicit DirectedWeightedGraph(size_t vertex_count);
-    EdgeId AddEdge(const Edge<Weight>& edge);
-
-    size_t GetVertexCount() const;
-    size_t GetEdgeCount() const;
-    const Edge<Weight>& GetEdge(EdgeId edge_id) const;
-    IncidentEdgesRange GetIncidentEdges(VertexId vertex) const;
-
-private:
-    std::vector<Edge<Weight>> edges_;
-    std::vector<IncidenceList> incidence_lists_;
-};
-
-template <typename Weight>
-DirectedWeightedGraph<Weight>::DirectedWeightedGraph(size_t vertex_count)
-    : incidence_lists_(vertex_count) {
-}
-
-template <typename Weight>
-EdgeId DirectedWeightedGraph<Weight>::AddEdge(const Edge<Weight>& edge) {
-    edges_.push_back(edge);
-    const EdgeId id = edges_.size() - 1;
-    incidence_lists_.at(edge.from).push_back(id);
-    return id;
-}
-
-template <typename Weight>
-size_t DirectedWeightedGraph<Weight>::GetVertexCount() const {
-    return incidence_lists_.size();
-}
-
-template <typename Weight>
-size_t DirectedWeightedGraph<Weight>::GetEdgeCount() const {
-    return edges_.size();
-}
-
-template <typename Weight>
-const Edge<Weight>& DirectedWeightedGraph<Weight>::GetEdge(EdgeId edge_id) const {
-    return edges_.at(edge_id);
-}
-
-template <typename Weight>
-typename DirectedWeightedGraph<Weight>::IncidentEdgesRange
-DirectedWeightedGraph<Weight>::GetIncidentEdges(VertexId vertex) const {
-    return ranges::AsRange(incidence_lists_.at(vertex));
-}
+#pragma once
+
+#include "ranges.h"
+
+#include <cstdlib>
+#include <stdexcept>
+#include <vector>
+
+namespace graph {
+
+using VertexId = size_t;
+using EdgeId = size_t;
+
+template <typename Weight>
+struct Edge {
+    VertexId from;
+    VertexId to;
+    Weight weight;
+};
+
+template <typename Weight>
+class DirectedWeightedGraph {
+private:
+    using IncidenceList = std::vector<EdgeId>;
+    using IncidentEdgesRange = ranges::Range<typename IncidenceList::const_iterator>;
+
+public:
+    DirectedWeightedGraph() = default;
+    explicit DirectedWeightedGraph(size_t vertex_count);
+    EdgeId AddEdge(const Edge<Weight>& edge);
+
+    // Упаковывает списки смежности в CSR (compressed sparse row): рёбра каждой вершины
+    // лежат подряд в массивах идентификаторов, концов и весов. Так же упаковываются входящие
+    // рёбра для обратного обхода. После вызова добавлять рёбра нельзя
+    void Freeze();
+    bool IsFrozen() const;
+
+    size_t GetVertexCount() const;
+    size_t GetEdgeCount() const;
+    const Edge<Weight>& GetEdge(EdgeId edge_id) const;
+    IncidentEdgesRange GetIncidentEdges(VertexId vertex) const;
+
+    // Вызывает callback(edge_id, to, weight) для каждого исходящего ребра вершины.
+    // После Freeze обход идёт по смежным ячейкам памяти без обращения к edges_
+    template <typename Callback>
+    void ForEachIncidentEdge(VertexId vertex, Callback&& callback) const;
+
+    // Вызывает callback(edge_id, from, weight) для каждого входящего ребра вершины.
+    // Доступно только после Freeze
+    template <typename Callback>
+    void ForEachIncomingEdge(VertexId vertex, Callback&& callback) const;
+
+private:
+    std::vector<Edge<Weight>> edges_;
+    std::vector<IncidenceList> incidence_lists_;
+
+    // CSR-представление: рёбра вершины v занимают индексы [offsets_[v], offsets_[v + 1])
+    bool frozen_ = false;
+    std::vector<size_t> offsets_;
+    std::vector<EdgeId> csr_edges_;
+    std::vector<VertexId> csr_targets_;
+    std::vector<Weight> csr_weights_;
+
+    // Обратное CSR-представление: входящие рёбра вершины v занимают [reverse_offsets_[v], reverse_offsets_[v + 1])
+    std::vector<size_t> reverse_offsets_;
+    std::vector<EdgeId> reverse_edges_;
+    std::vector<VertexId> reverse_sources_;
+    std::vector<Weight> reverse_weights_;
+};
+
+template <typename Weight>
+DirectedWeightedGraph<Weight>::DirectedWeightedGraph(size_t vertex_count)
+    : incidence_lists_(vertex_count) {
+}
+
+template <typename Weight>
+EdgeId DirectedWeightedGraph<Weight>::AddEdge(const Edge<Weight>& edge) {
+    if (frozen_) {
+        throw std::logic_error("Graph is frozen");
+    }
+    edges_.push_back(edge);
+    const EdgeId id = edges_.size() - 1;
+    incidence_lists_.at(edge.from).push_back(id);
+    return id;
+}
+
+template <typename Weight>
+void DirectedWeightedGraph<Weight>::Freeze() {
+    if (frozen_) {
+        return;
+    }
+    const size_t vertex_count = incidence_lists_.size();
+    offsets_.assign(vertex_count + 1, 0);
+    csr_edges_.reserve(edges_.size());
+    csr_targets_.reserve(edges_.size());
+    csr_weights_.reserve(edges_.size());
+    for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+        for (const EdgeId edge_id : incidence_lists_[vertex]) {
+            csr_edges_.push_back(edge_id);
+            csr_targets_.push_back(edges_[edge_id].to);
+            csr_weights_.push_back(edges_[edge_id].weight);
+        }
+        offsets_[vertex + 1] = csr_edges_.size();
+    }
+
+    // Подсчёт входящих рёбер и раскладка по вершинам в порядке идентификаторов рёбер
+    reverse_offsets_.assign(vertex_count + 1, 0);
+    for (const Edge<Weight>& edge : edges_) {
+        ++reverse_offsets_[edge.to + 1];
+    }
+    for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+        reverse_offsets_[vertex + 1] += reverse_offsets_[vertex];
+    }
+    reverse_edges_.resize(edges_.size());
+    reverse_sources_.resize(edges_.size());
+    reverse_weights_.resize(edges_.size());
+    std::vector<size_t> positions(reverse_offsets_.begin(), reverse_offsets_.end() - 1);
+    for (EdgeId edge_id = 0; edge_id < edges_.size(); ++edge_id) {
+        const size_t position = positions[edges_[edge_id].to]++;
+        reverse_edges_[position] = edge_id;
+        reverse_sources_[position] = edges_[edge_id].from;
+        reverse_weights_[position] = edges_[edge_id].weight;
+    }
+    incidence_lists_.clear();
+    incidence_lists_.shrink_to_fit();
+    frozen_ = true;
+}
+
+template <typename Weight>
+bool DirectedWeightedGraph<Weight>::IsFrozen() const {
+    return frozen_;
+}
+
+template <typename Weight>
+size_t DirectedWeightedGraph<Weight>::GetVertexCount() const {
+    return frozen_ ? offsets_.size() - 1 : incidence_lists_.size();
+}
+
+template <typename Weight>
+size_t DirectedWeightedGraph<Weight>::GetEdgeCount() const {
+    return edges_.size();
+}
+
+template <typename Weight>
+const Edge<Weight>& DirectedWeightedGraph<Weight>::GetEdge(EdgeId edge_id) const {
+    return edges_.at(edge_id);
+}
+
+template <typename Weight>
+typename DirectedWeightedGraph<Weight>::IncidentEdgesRange
+DirectedWeightedGraph<Weight>::GetIncidentEdges(VertexId vertex) const {
+    if (frozen_) {
+        const auto first = csr_edges_.begin();
+        return {first + offsets_.at(vertex), first + offsets_.at(vertex + 1)};
+    }
+    return ranges::AsRange(incidence_lists_.at(vertex));
+}
+
+template <typename Weight>
+template <typename Callback>
+void DirectedWeightedGraph<Weight>::ForEachIncidentEdge(VertexId vertex, Callback&& callback) const {
+    if (frozen_) {
+        for (size_t i = offsets_[vertex], last = offsets_[vertex + 1]; i < last; ++i) {
+            callback(csr_edges_[i], csr_targets_[i], csr_weights_[i]);
+        }
+        return;
+    }
+    for (const EdgeId edge_id : incidence_lists_[vertex]) {
+        const Edge<Weight>& edge = edges_[edge_id];
+        callback(edge_id, edge.to, edge.weight);
+    }
+}
+
+template <typename Weight>
+template <typename Callback>
+void DirectedWeightedGraph<Weight>::ForEachIncomingEdge(VertexId vertex, Callback&& callback) const {
+    if (!frozen_) {
+        throw std::logic_error("Incoming edges are available only after Freeze");
+    }
+    for (size_t i = reverse_offsets_[vertex], last = reverse_offsets_[vertex + 1]; i < last; ++i) {
+        callback(reverse_edges_[i], reverse_sources_[i], reverse_weights_[i]);
+    }
+}
 }  // namespace graph
\ No newline at end of file
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstddef>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+
+namespace transport_router {
+	// Счётчики обращений к кэшу
+	struct CacheStats {
+		size_t hits = 0;
+		size_t misses = 0;
+		size_t size = 0;
+		size_t capacity = 0;
+	};
+
+	// Ограниченный кэш с вытеснением давно не использованных записей (LRU).
+	// Все операции выполняются под мьютексом, поэтому кэш можно разделять между потоками.
+	// Ёмкость 0 отключает кэш: Get всегда промахивается, Put ничего не хранит
+	template <typename Key, typename Value, typename Hash = std::hash<Key>>
+	class LruCache {
+	public:
+		explicit LruCache(size_t capacity = 0)
+			: capacity_{ capacity } {
+		}
+
+		std::optional<Value> Get(const Key& key) {
+			std::lock_guard guard(mutex_);
+			const auto it = index_.find(key);
+			if (it == index_.end()) {
+				++misses_;
+				return std::nullopt;
+			}
+			++hits_;
+			entries_.splice(entries_.begin(), entries_, it->second);
+			return it->second->second;
+		}
+
+		void Put(const Key& key, Value value) {
+			std::lock_guard guard(mutex_);
+			if (capacity_ == 0) {
+				return;
+			}
+			if (const auto it = index_.find(key); it != index_.end()) {
+				it->second->second = std::move(value);
+				entries_.splice(entries_.begin(), entries_, it->second);
+				return;
+			}
+			if (entries_.size() == capacity_) {
+				index_.erase(entries_.back().first);
+				entries_.pop_back();
+			}
+			entries_.emplace_front(key, std::move(value));
+			index_.emplace(key, entries_.begin());
+		}
+
+		// Удаляет все записи и сбрасывает счётчики, ёмкость задаётся заново
+		void Reset(size_t capacity) {
+			std::lock_guard guard(mutex_);
+			capacity_ = capacity;
+			entries_.clear();
+			index_.clear();
+			hits_ = 0;
+			misses_ = 0;
+		}
+
+		// Удаляет все записи, сохраняя счётчики
+		void Clear() {
+			std::lock_guard guard(mutex_);
+			entries_.clear();
+			index_.clear();
+		}
+
+		CacheStats GetStats() const {
+			std::lock_guard guard(mutex_);
+			return { hits_, misses_, entries_.size(), capacity_ };
+		}
+
+	private:
+		using Entries = std::list<std::pair<Key, Value>>;
+
+		mutable std::mutex mutex_;
+		size_t capacity_;
+		Entries entries_;
+		std::unordered_map<Key, typename Entries::iterator, Hash> index_;
+		size_t hits_ = 0;
+		size_t misses_ = 0;
+	};
+} // namespace transport_router
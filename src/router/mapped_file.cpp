@@ -0,0 +1,64 @@
+#include "mapped_file.h"
+
+#include <fstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define TRANSPORT_ROUTER_HAS_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace transport_router {
+	std::unique_ptr<MappedFile> MappedFile::Open(const std::string& path) {
+		std::unique_ptr<MappedFile> file(new MappedFile());
+#ifdef TRANSPORT_ROUTER_HAS_MMAP
+		const int fd = ::open(path.c_str(), O_RDONLY);
+		if (fd < 0) {
+			return nullptr;
+		}
+		struct stat info {};
+		if (::fstat(fd, &info) != 0) {
+			::close(fd);
+			return nullptr;
+		}
+		file->size_ = static_cast<size_t>(info.st_size);
+		if (file->size_ > 0) {
+			void* data = ::mmap(nullptr, file->size_, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (data != MAP_FAILED) {
+				file->data_ = static_cast<const std::byte*>(data);
+				file->mapped_ = true;
+			}
+		}
+		::close(fd);
+		if (file->mapped_ || file->size_ == 0) {
+			return file;
+		}
+#endif
+		std::ifstream input(path, std::ios::binary | std::ios::ate);
+		if (!input) {
+			return nullptr;
+		}
+		file->buffer_.resize(static_cast<size_t>(input.tellg()));
+		input.seekg(0);
+		if (!input.read(reinterpret_cast<char*>(file->buffer_.data()), static_cast<std::streamsize>(file->buffer_.size()))) {
+			return nullptr;
+		}
+		file->data_ = file->buffer_.data();
+		file->size_ = file->buffer_.size();
+		return file;
+	}
+
+	MappedFile::~MappedFile() {
+#ifdef TRANSPORT_ROUTER_HAS_MMAP
+		if (mapped_) {
+			::munmap(const_cast<std::byte*>(data_), size_);
+		}
+#endif
+	}
+
+	std::span<const std::byte> MappedFile::GetData() const {
+		return { data_, size_ };
+	}
+} // namespace transport_router
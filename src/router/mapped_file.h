@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace transport_router {
+	// Файл, открытый только для чтения и отображённый в память. На POSIX-системах
+	// используется mmap, на остальных содержимое файла читается в буфер
+	class MappedFile {
+	public:
+		// Возвращает nullptr, если файл не существует или не читается
+		static std::unique_ptr<MappedFile> Open(const std::string& path);
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+		~MappedFile();
+
+		std::span<const std::byte> GetData() const;
+
+	private:
+		MappedFile() = default;
+
+		const std::byte* data_ = nullptr;
+		size_t size_ = 0;
+		bool mapped_ = false;
+		std::vector<std::byte> buffer_;
+	};
+} // namespace transport_router
@@ -0,0 +1,205 @@
+#include "raptor_router.h"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+namespace transport_router {
+	RaptorRouter::RaptorRouter(const TransportCatalogue& catalogue, Time bus_wait, DistToTime dist_to_time)
+		: bus_wait_{ bus_wait }
+		, stop_index_(catalogue.GetStopCount(), NONE) {
+		for (const Route& route : catalogue.GetRoutes()) {
+			if (route.driving_route.empty()) {
+				continue;
+			}
+			RouteData data{ .route = &route };
+			for (const BusStop* stop : route.driving_route) {
+				if (stop_index_[stop->id] == NONE) {
+					stop_index_[stop->id] = static_cast<uint32_t>(stop_count_++);
+				}
+				data.stops.push_back(stop_index_[stop->id]);
+			}
+
+			const auto& stops = route.driving_route;
+			data.segments.assign(stops.size(), 0);
+			for (size_t j = 1; j < stops.size(); ++j) {
+				if (auto dist = catalogue.GetStopsDistance(stops[j - 1]->id, stops[j]->id, !route.round_trip)) {
+					data.segments[j] = dist_to_time(dist.value());
+				} else {
+					data.regular = false;
+				}
+			}
+
+			// Те же переходы, что TransportRouter::CreateBusEdges строит для графа
+			if (!data.regular) {
+				for (size_t from = 0; from < stops.size(); ++from) {
+					Time total_time = 0;
+					size_t prev = from;
+					for (size_t to = from + 1; to < stops.size(); ++to) {
+						if (auto dist = catalogue.GetStopsDistance(stops[prev]->id, stops[to]->id, !route.round_trip)) {
+							total_time += dist_to_time(dist.value());
+						} else {
+							continue;
+						}
+						prev = to;
+						data.hops.push_back({ static_cast<uint32_t>(from), static_cast<uint32_t>(to), total_time });
+					}
+				}
+			}
+			routes_.push_back(std::move(data));
+		}
+
+		stop_routes_offsets_.assign(stop_count_ + 1, 0);
+		for (const RouteData& route : routes_) {
+			for (const uint32_t stop : route.stops) {
+				++stop_routes_offsets_[stop + 1];
+			}
+		}
+		for (size_t stop = 0; stop < stop_count_; ++stop) {
+			stop_routes_offsets_[stop + 1] += stop_routes_offsets_[stop];
+		}
+		stop_routes_.resize(stop_routes_offsets_.back());
+		std::vector<size_t> positions(stop_routes_offsets_.begin(), stop_routes_offsets_.end() - 1);
+		for (uint32_t route = 0; route < routes_.size(); ++route) {
+			for (uint32_t position = 0; position < routes_[route].stops.size(); ++position) {
+				stop_routes_[positions[routes_[route].stops[position]]++] = { route, position };
+			}
+		}
+	}
+
+	std::optional<RaptorRouter::Journey> RaptorRouter::BuildRoute(const BusStop* from, const BusStop* to) const {
+		const uint32_t source = FindStop(from);
+		const uint32_t target = FindStop(to);
+		if (source == NONE || target == NONE) {
+			return std::nullopt;
+		}
+		if (source == target) {
+			return Journey{};
+		}
+
+		const SearchResult search = Search(source, target);
+		if (search.best[target] == std::numeric_limits<Time>::infinity()) {
+			return std::nullopt;
+		}
+		Journey journey{ .total_time = search.best[target], .legs{}, .stats = search.stats };
+		uint32_t stop = target;
+		for (size_t round = search.labels.size() - 1; stop != source; --round) {
+			const Parent& parent = search.parents[round][stop];
+			if (parent.route == NONE) {
+				continue;
+			}
+			const RouteData& data = routes_[parent.route];
+			journey.legs.push_back({ data.route, parent.board, parent.alight, parent.time });
+			stop = data.stops[parent.board];
+		}
+		std::ranges::reverse(journey.legs);
+		return journey;
+	}
+
+	std::vector<std::optional<Time>> RaptorRouter::BuildTimes(const BusStop* from, const std::vector<const BusStop*>& targets) const {
+		std::vector<std::optional<Time>> result(targets.size());
+		const uint32_t source = FindStop(from);
+		if (source == NONE) {
+			return result;
+		}
+		const SearchResult search = Search(source, NONE);
+		for (size_t i = 0; i < targets.size(); ++i) {
+			const uint32_t target = FindStop(targets[i]);
+			if (target != NONE && search.best[target] != std::numeric_limits<Time>::infinity()) {
+				result[i] = search.best[target];
+			}
+		}
+		return result;
+	}
+
+	uint32_t RaptorRouter::FindStop(const BusStop* stop) const {
+		return stop != nullptr && stop->id < stop_index_.size() ? stop_index_[stop->id] : NONE;
+	}
+
+	RaptorRouter::SearchResult RaptorRouter::Search(uint32_t source, uint32_t target) const {
+		constexpr Time INF = std::numeric_limits<Time>::infinity();
+		const size_t stop_count = stop_count_;
+		SearchResult result{
+			.labels{ std::vector<Time>(stop_count, INF) },
+			.parents{ std::vector<Parent>(stop_count) },
+			.best = std::vector<Time>(stop_count, INF),
+			.stats{}
+		};
+		std::vector<bool> marked(stop_count, false);
+		std::vector<uint32_t> marked_stops{ source };
+		std::vector<uint32_t> route_first(routes_.size(), NONE);
+		std::vector<uint32_t> scan_routes;
+		result.labels[0][source] = 0;
+		result.best[source] = 0;
+		std::vector<Time>& best = result.best;
+
+		while (!marked_stops.empty()) {
+			for (const uint32_t stop : marked_stops) {
+				marked[stop] = false;
+				for (size_t i = stop_routes_offsets_[stop]; i < stop_routes_offsets_[stop + 1]; ++i) {
+					const auto [route, position] = stop_routes_[i];
+					if (route_first[route] == NONE) {
+						scan_routes.push_back(route);
+					}
+					route_first[route] = std::min(route_first[route], position);
+				}
+			}
+			marked_stops.clear();
+
+			const std::vector<Time>& prev_labels = result.labels.back();
+			std::vector<Time> round_labels = prev_labels;
+			std::vector<Parent> round_parents(stop_count);
+
+			auto improve = [&](uint32_t route, uint32_t board, uint32_t alight, Time time, Time arrival) {
+				const uint32_t stop = routes_[route].stops[alight];
+				if (arrival < best[stop] && (target == NONE || arrival < best[target])) {
+					++result.stats.settled_vertices;
+					round_labels[stop] = arrival;
+					best[stop] = arrival;
+					round_parents[stop] = Parent{ route, board, alight, time };
+					if (!marked[stop]) {
+						marked[stop] = true;
+						marked_stops.push_back(stop);
+					}
+				}
+			};
+
+			for (const uint32_t route : scan_routes) {
+				const RouteData& data = routes_[route];
+				const uint32_t first = std::exchange(route_first[route], NONE);
+				if (!data.regular) {
+					for (const Hop& hop : data.hops) {
+						++result.stats.relaxed_edges;
+						const Time departure = prev_labels[data.stops[hop.board]];
+						if (hop.board >= first && departure < INF) {
+							improve(route, hop.board, hop.alight, hop.time, departure + bus_wait_ + hop.time);
+						}
+					}
+					continue;
+				}
+
+				// Текущая поездка: посадка на позиции board с временем departure (прибытие + ожидание)
+				uint32_t board = NONE;
+				Time departure = INF;
+				Time time = 0;
+				for (uint32_t position = first; position < data.stops.size(); ++position) {
+					++result.stats.relaxed_edges;
+					if (board != NONE) {
+						time += data.segments[position];
+						improve(route, board, position, time, departure + time);
+					}
+					const Time label = prev_labels[data.stops[position]];
+					if (label < INF && (board == NONE || label + bus_wait_ < departure + time)) {
+						board = position;
+						departure = label + bus_wait_;
+						time = 0;
+					}
+				}
+			}
+			scan_routes.clear();
+			result.labels.push_back(std::move(round_labels));
+			result.parents.push_back(std::move(round_parents));
+		}
+		return result;
+	}
+} // namespace transport_router
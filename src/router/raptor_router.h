@@ -0,0 +1,102 @@
+#pragma once
+
+#include "router.h"
+#include "transport_catalogue.h"
+
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <vector>
+
+namespace transport_router {
+	using Time = double;
+
+	// Поиск по маршрутам раундами (RAPTOR) без графа: раунд k находит лучшее время прибытия
+	// на каждую остановку не более чем с k поездками, просматривая маршруты через остановки,
+	// улучшенные в предыдущем раунде. Каждая посадка стоит bus_wait, время поездки - сумма
+	// времён перегонов от остановки посадки. Рёбра «каждая остановка с каждой последующей»
+	// не создаются: память O(суммы длин маршрутов), раунд - O(длины просмотренных маршрутов).
+	// Ответы совпадают с поиском по графу TransportRouter
+	class RaptorRouter {
+	public:
+		using DistToTime = std::function<Time(size_t dist)>;
+
+		// Поездка на автобусе route от позиции board до позиции alight в driving_route
+		struct Leg {
+			const Route* route = nullptr;
+			size_t board = 0;
+			size_t alight = 0;
+			Time time = 0;
+		};
+
+		struct Journey {
+			Time total_time = 0;
+			std::vector<Leg> legs;
+			graph::SearchStats stats; // settled_vertices - улучшения меток, relaxed_edges - просмотренные позиции маршрутов
+		};
+
+		RaptorRouter(const TransportCatalogue& catalogue, Time bus_wait, DistToTime dist_to_time);
+
+		std::optional<Journey> BuildRoute(const BusStop* from, const BusStop* to) const;
+
+		// Времена в пути из from до каждой остановки targets за один поиск без отсечения по цели,
+		// nullopt - маршрута нет
+		std::vector<std::optional<Time>> BuildTimes(const BusStop* from, const std::vector<const BusStop*>& targets) const;
+
+	private:
+		static constexpr uint32_t NONE = UINT32_MAX;
+
+		// Переход между позициями маршрута, по которому можно проехать без высадки
+		struct Hop {
+			uint32_t board;
+			uint32_t alight;
+			Time time;
+		};
+
+		struct RouteData {
+			const Route* route = nullptr;
+			std::vector<uint32_t> stops{}; // номера остановок по позициям driving_route
+			std::vector<Time> segments{};  // segments[j] - время перегона j - 1 -> j
+			// Если у маршрута нет расстояния между соседними остановками, граф пропускает такую
+			// остановку и считает время от последней доступной. Для таких маршрутов переходы
+			// хранятся явно, как рёбра в графе; у остальных hops пуст
+			bool regular = true;
+			std::vector<Hop> hops{};
+		};
+
+		struct StopRoute {
+			uint32_t route;
+			uint32_t position;
+		};
+
+		struct Parent {
+			uint32_t route = NONE;
+			uint32_t board = 0;
+			uint32_t alight = 0;
+			Time time = 0;
+		};
+
+		// Результат раундов: labels[k][s] - лучшее прибытие на s не более чем с k поездками,
+		// parents[k][s] - поездка, которой оно достигнуто в раунде k (route == NONE, если метка
+		// унаследована из раунда k - 1), best[s] - лучшее прибытие по всем раундам
+		struct SearchResult {
+			std::vector<std::vector<Time>> labels;
+			std::vector<std::vector<Parent>> parents;
+			std::vector<Time> best;
+			graph::SearchStats stats;
+		};
+
+		// target == NONE отключает отсечение по времени прибытия в цель
+		SearchResult Search(uint32_t source, uint32_t target) const;
+		uint32_t FindStop(const BusStop* stop) const;
+
+		Time bus_wait_;
+		// Номер остановки в поиске по StopId, NONE - остановка не входит в маршруты
+		std::vector<uint32_t> stop_index_;
+		size_t stop_count_ = 0;
+		std::vector<RouteData> routes_;
+		// Маршруты через остановку s занимают [stop_routes_offsets_[s], stop_routes_offsets_[s + 1])
+		std::vector<size_t> stop_routes_offsets_;
+		std::vector<StopRoute> stop_routes_;
+	};
+} // namespace transport_router
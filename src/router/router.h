@@ -1,117 +1,456 @@
-#pragma once
-
-#include "graph.h"
-
-#include <algorithm>
-#include <cassert>
-#include <cstdint>
-#include <iterator>
-#include <optional>
-#include <stdexcept>
-#include <unordered_map>
-#include <utility>
-#include <vector>
-
-namespace graph {
-
-template <typename Weight>
-class Router {
-private:
-    using Graph = DirectedWeightedGraph<Weight>;
-
-public:
-    explicit Router(const Graph& graph);
-
-    struct RouteInfo {
-        Weight weight;
-        std::vector<EdgeId> edges;
-    };
-
-    std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to) const;
-
-private:
-    struct RouteInternalData {
-        Weight weight;
-        std::optional<EdgeId> prev_edge;
-    };
-    using RoutesInternalData = std::vector<std::vector<std::optional<RouteInternalData>>>;
-
-    void InitializeRoutesInternalData(const Graph& graph) {
-        const size_t vertex_count = graph.GetVertexCount();
-        for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
-            routes_internal_data_[vertex][vertex] = RouteInternalData{ZERO_WEIGHT, std::nullopt};
-            for (const EdgeId edge_id : graph.GetIncidentEdges(vertex)) {
-                const auto& edge = graph.GetEdge(edge_id);
-                if (edge.weight < ZERO_WEIGHT) {
-                    throw std::domain_error("Edges' weights should be non-negative");
-                }
-                auto& route_internal_data = routes_internal_data_[vertex][edge.to];
-                if (!route_internal_data || route_internal_data->weight > edge.weight) {
-                    route_internal_data = RouteInternalData{edge.weight, edge_id};
-                }
-            }
-        }
-    }
-
-    void RelaxRoute(VertexId vertex_from, VertexId vertex_to, const RouteInternalData& route_from,
-                    const RouteInternalData& route_to) {
-        auto& route_relaxing = routes_internal_data_[vertex_from][vertex_to];
-        const Weight candidate_weight = route_from.weight + route_to.weight;
-        if (!route_relaxing || candidate_weight < route_relaxing->weight) {
-            route_relaxing = {candidate_weight,
-                              route_to.prev_edge ? route_to.prev_edge : route_from.prev_edge};
-        }
-    }
-
-    void RelaxRoutesInternalDataThroughVertex(size_t vertex_count, VertexId vertex_through) {
-        for (VertexId vertex_from = 0; vertex_from < vertex_count; ++vertex_from) {
-            if (const auto& route_from = routes_internal_data_[vertex_from][vertex_through]) {
-                for (VertexId vertex_to = 0; vertex_to < vertex_count; ++vertex_to) {
-                    if (const auto& route_to = routes_internal_data_[vertex_through][vertex_to]) {
-                        RelaxRoute(vertex_from, vertex_to, *route_from, *route_to);
-                    }
-                }
-            }
-        }
-    }
-
-    static constexpr Weight ZERO_WEIGHT{};
-    const Graph& graph_;
-    RoutesInternalData routes_internal_data_;
-};
-
-template <typename Weight>
-Router<Weight>::Router(const Graph& graph)
-    : graph_(graph)
-    , routes_internal_data_(graph.GetVertexCount(),
-                            std::vector<std::optional<RouteInternalData>>(graph.GetVertexCount()))
-{
-    InitializeRoutesInternalData(graph);
-
-    const size_t vertex_count = graph.GetVertexCount();
-    for (VertexId vertex_through = 0; vertex_through < vertex_count; ++vertex_through) {
-        RelaxRoutesInternalDataThroughVertex(vertex_count, vertex_through);
-    }
-}
-
-template <typename Weight>
-std::optional<typename Router<Weight>::RouteInfo> Router<Weight>::BuildRoute(VertexId from,
-                                                                             VertexId to) const {
-    const auto& route_internal_data = routes_internal_data_.at(from).at(to);
-    if (!route_internal_data) {
-        return std::nullopt;
-    }
-    const Weight weight = route_internal_data->weight;
-    std::vector<EdgeId> edges;
-    for (std::optional<EdgeId> edge_id = route_internal_data->prev_edge;
-         edge_id;
-         edge_id = routes_internal_data_[from][graph_.GetEdge(*edge_id).from]->prev_edge)
-    {
-        edges.push_back(*edge_id);
-    }
-    std::reverse(edges.begin(), edges.end());
-
-    return RouteInfo{weight, std::move(edges)};
-}
-
+#pragma once
+
+#include "graph.h"
+#include "shortest_path_tree.h"
+
+#include <algorithm>
+#include <atomic>
+#include <barrier>
+#include <cassert>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+// Статистика одного поиска: сколько вершин извлечено из очереди и сколько рёбер просмотрено
+struct SearchStats {
+    size_t settled_vertices = 0;
+    size_t relaxed_edges = 0;
+};
+
+// Общий интерфейс поиска кратчайшего пути между вершинами графа
+template <typename Weight>
+class RouterBase {
+public:
+    struct RouteInfo {
+        Weight weight;
+        std::vector<EdgeId> edges;
+        SearchStats stats{};
+    };
+
+    virtual ~RouterBase() = default;
+
+    virtual std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to) const = 0;
+
+    // Веса кратчайших путей из from до каждой вершины targets, nullopt - пути нет.
+    // По умолчанию - отдельный BuildRoute на каждую цель; движки, которые строят дерево
+    // путей из from, переопределяют метод и проходят его один раз на все цели
+    virtual std::vector<std::optional<Weight>> BuildWeights(VertexId from, std::span<const VertexId> targets) const {
+        std::vector<std::optional<Weight>> result;
+        result.reserve(targets.size());
+        for (const VertexId to : targets) {
+            const auto route = BuildRoute(from, to);
+            result.push_back(route ? std::optional<Weight>(route->weight) : std::nullopt);
+        }
+        return result;
+    }
+};
+
+// Предрасчёт всех пар вершин алгоритмом Флойда–Уоршелла: O(V^3) времени и O(V^2) памяти.
+// Подходит только для небольших сетей. Строки таблицы обрабатываются плитками по
+// thread_count потокам; результат, включая выбор prev_edge при равных весах, не зависит
+// от числа потоков.
+// Таблица хранится двумя плоскими массивами V x V: веса типа StoredWeight (бесконечность -
+// нет пути) и 32-битные номера последних рёбер. StoredWeight = float вдвое сокращает память
+// под веса ценой точности сравнения; вес найденного маршрута всё равно суммируется по рёбрам графа.
+// Готовую таблицу можно сохранить через GetWeights/GetPrevEdges и позже передать в Router
+// без пересчёта, например из отображённого в память файла.
+// Если заранее известно, из каких вершин будут запросы, таблица строится только из их строк
+template <typename Weight, typename StoredWeight = Weight>
+class Router : public RouterBase<Weight> {
+private:
+    using Graph = DirectedWeightedGraph<Weight>;
+
+public:
+    using StoredEdgeId = std::uint32_t;
+
+private:
+    static_assert(std::numeric_limits<StoredWeight>::has_infinity,
+                  "Stored weight should have an infinity value to mark missing routes");
+
+public:
+    using typename RouterBase<Weight>::RouteInfo;
+
+    // Байт таблицы на одну пару вершин
+    static constexpr size_t BYTES_PER_PAIR = sizeof(StoredWeight) + sizeof(StoredEdgeId);
+
+    explicit Router(const Graph& graph, size_t thread_count = 1);
+
+    // Таблица, построенная ранее для того же графа. storage владеет памятью таблицы
+    // и живёт, пока жив Router
+    Router(const Graph& graph, std::span<const StoredWeight> weights, std::span<const StoredEdgeId> prev_edges,
+           std::shared_ptr<const void> storage);
+
+    // Таблица только из строк sources: поиск Дейкстры из каждой вершины, O(S (V + E) log V)
+    // времени и O(S V) памяти вместо O(V^3) и O(V^2). Запрос из вершины вне sources
+    // выполняется поиском Дейкстры в момент запроса
+    Router(const Graph& graph, std::span<const VertexId> sources, size_t thread_count = 1);
+
+    Router(const Router&) = delete;
+    Router& operator=(const Router&) = delete;
+
+    std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to) const override;
+
+    // Таблица содержит строки не всех вершин
+    bool IsPartial() const {
+        return !source_rows_.empty();
+    }
+
+    size_t GetTableBytes() const {
+        return table_weights_.size() * BYTES_PER_PAIR;
+    }
+
+    std::span<const StoredWeight> GetWeights() const {
+        return table_weights_;
+    }
+
+    std::span<const StoredEdgeId> GetPrevEdges() const {
+        return table_prev_edges_;
+    }
+
+    // Восстанавливает таблицу после перестроения графа graph_ без полного пересчёта.
+    // edge_remap[e] - номер старого ребра e в новом графе или nullopt, если ребро удалено или
+    // изменило вес; inserted_edges - рёбра нового графа, которых не было в старом. Новые вершины
+    // получают номера после старых. Строки, чьё дерево путей проходило по удалённым рёбрам,
+    // пересчитываются алгоритмом Дейкстры, вставленные рёбра учитываются релаксацией всех
+    // строк через начало каждого ребра: O(V^2) на каждую такую вершину вместо O(V^3).
+    // Частичную таблицу обновить нельзя, её строят заново
+    void Update(std::span<const std::optional<EdgeId>> edge_remap, std::span<const EdgeId> inserted_edges);
+
+private:
+    static constexpr StoredWeight NO_ROUTE = std::numeric_limits<StoredWeight>::infinity();
+    static constexpr StoredEdgeId NO_EDGE = std::numeric_limits<StoredEdgeId>::max();
+    static constexpr size_t NO_ROW = std::numeric_limits<size_t>::max();
+
+    size_t Row(VertexId from) const {
+        return source_rows_.empty() ? from : source_rows_[from];
+    }
+
+    size_t Cell(VertexId from, VertexId to) const {
+        return Row(from) * vertex_count_ + to;
+    }
+
+    std::optional<RouteInfo> BuildRouteFromTree(VertexId from, VertexId to) const;
+
+    void InitializeRoutesInternalData(const Graph& graph) {
+        if (graph.GetEdgeCount() >= NO_EDGE) {
+            throw std::length_error("Too many edges for the all-pairs table");
+        }
+        for (VertexId vertex = 0; vertex < vertex_count_; ++vertex) {
+            weights_[Cell(vertex, vertex)] = StoredWeight{};
+            for (const EdgeId edge_id : graph.GetIncidentEdges(vertex)) {
+                const auto& edge = graph.GetEdge(edge_id);
+                if (edge.weight < ZERO_WEIGHT) {
+                    throw std::domain_error("Edges' weights should be non-negative");
+                }
+                const size_t cell = Cell(vertex, edge.to);
+                const auto weight = static_cast<StoredWeight>(edge.weight);
+                if (weights_[cell] > weight) {
+                    weights_[cell] = weight;
+                    prev_edges_[cell] = static_cast<StoredEdgeId>(edge_id);
+                }
+            }
+        }
+    }
+
+    // За шаг vertex_through меняются только ячейки вне строки и столбца vertex_through
+    // (путь через саму вершину не короче), поэтому строки можно релаксировать независимо.
+    // Внутренний цикл без ветвлений по плоским массивам, компилятор его векторизует
+    void RelaxRowsThroughVertex(VertexId vertex_through, VertexId row_begin, VertexId row_end) {
+        const StoredWeight* const weights_through = &weights_[Cell(vertex_through, 0)];
+        const StoredEdgeId* const prev_through = &prev_edges_[Cell(vertex_through, 0)];
+        for (VertexId vertex_from = row_begin; vertex_from < row_end; ++vertex_from) {
+            const StoredWeight weight_from = weights_[Cell(vertex_from, vertex_through)];
+            if (weight_from == NO_ROUTE) {
+                continue;
+            }
+            const StoredEdgeId prev_from = prev_edges_[Cell(vertex_from, vertex_through)];
+            StoredWeight* const weights_row = &weights_[Cell(vertex_from, 0)];
+            StoredEdgeId* const prev_row = &prev_edges_[Cell(vertex_from, 0)];
+            for (VertexId vertex_to = 0; vertex_to < vertex_count_; ++vertex_to) {
+                const StoredWeight candidate_weight = weight_from + weights_through[vertex_to];
+                const StoredEdgeId candidate_prev = prev_through[vertex_to] != NO_EDGE ? prev_through[vertex_to] : prev_from;
+                const bool relaxed = candidate_weight < weights_row[vertex_to];
+                weights_row[vertex_to] = relaxed ? candidate_weight : weights_row[vertex_to];
+                prev_row[vertex_to] = relaxed ? candidate_prev : prev_row[vertex_to];
+            }
+        }
+    }
+
+    void SetRowFromTree(VertexId vertex_from) {
+        const auto tree = BuildShortestPathTree(graph_, vertex_from);
+        for (VertexId vertex_to = 0; vertex_to < vertex_count_; ++vertex_to) {
+            const size_t cell = Cell(vertex_from, vertex_to);
+            weights_[cell] = tree.reached[vertex_to] ? static_cast<StoredWeight>(tree.weights[vertex_to]) : NO_ROUTE;
+            prev_edges_[cell] = tree.prev_edges[vertex_to] == tree.NO_EDGE
+                ? NO_EDGE : static_cast<StoredEdgeId>(tree.prev_edges[vertex_to]);
+        }
+    }
+
+    void RelaxRoutesInternalDataThroughVertex(VertexId vertex_through) {
+        RelaxRowsThroughVertex(vertex_through, 0, vertex_count_);
+    }
+
+    // Потоки разбирают плитки строк из общего счётчика, барьер завершает шаг vertex_through
+    void RelaxRoutesInternalDataParallel(size_t thread_count) {
+        const size_t tile_count = (vertex_count_ + ROW_TILE_SIZE - 1) / ROW_TILE_SIZE;
+        std::atomic<size_t> next_tile{0};
+        VertexId vertex_through = 0;
+        std::barrier sync(static_cast<std::ptrdiff_t>(thread_count), [&]() noexcept {
+            next_tile = 0;
+            ++vertex_through;
+        });
+
+        auto worker = [&] {
+            while (vertex_through < vertex_count_) {
+                for (size_t tile = next_tile++; tile < tile_count; tile = next_tile++) {
+                    const VertexId row_begin = tile * ROW_TILE_SIZE;
+                    const VertexId row_end = std::min(row_begin + ROW_TILE_SIZE, vertex_count_);
+                    RelaxRowsThroughVertex(vertex_through, row_begin, row_end);
+                }
+                sync.arrive_and_wait();
+            }
+        };
+
+        std::vector<std::jthread> threads;
+        for (size_t i = 1; i < thread_count; ++i) {
+            threads.emplace_back(worker);
+        }
+        worker();
+    }
+
+    static constexpr Weight ZERO_WEIGHT{};
+    static constexpr size_t ROW_TILE_SIZE = 32;
+    const Graph& graph_;
+    size_t vertex_count_;
+    // Номер строки таблицы для каждой вершины (NO_ROW - строки нет), пусто - строки всех вершин
+    std::vector<size_t> source_rows_;
+    // Таблица, заполняемая при построении
+    std::vector<StoredWeight> weights_;
+    std::vector<StoredEdgeId> prev_edges_;
+    // Таблица, по которой отвечают запросы: собственная или внешняя
+    std::span<const StoredWeight> table_weights_;
+    std::span<const StoredEdgeId> table_prev_edges_;
+    std::shared_ptr<const void> storage_;
+};
+
+template <typename Weight, typename StoredWeight>
+Router<Weight, StoredWeight>::Router(const Graph& graph, size_t thread_count)
+    : graph_(graph)
+    , vertex_count_(graph.GetVertexCount())
+    , weights_(vertex_count_ * vertex_count_, NO_ROUTE)
+    , prev_edges_(vertex_count_ * vertex_count_, NO_EDGE)
+{
+    InitializeRoutesInternalData(graph);
+
+    thread_count = std::min(thread_count, (vertex_count_ + ROW_TILE_SIZE - 1) / ROW_TILE_SIZE);
+    if (thread_count > 1) {
+        RelaxRoutesInternalDataParallel(thread_count);
+    } else {
+        for (VertexId vertex_through = 0; vertex_through < vertex_count_; ++vertex_through) {
+            RelaxRoutesInternalDataThroughVertex(vertex_through);
+        }
+    }
+    table_weights_ = weights_;
+    table_prev_edges_ = prev_edges_;
+}
+
+template <typename Weight, typename StoredWeight>
+Router<Weight, StoredWeight>::Router(const Graph& graph, std::span<const StoredWeight> weights,
+                                     std::span<const StoredEdgeId> prev_edges, std::shared_ptr<const void> storage)
+    : graph_(graph)
+    , vertex_count_(graph.GetVertexCount())
+    , table_weights_(weights)
+    , table_prev_edges_(prev_edges)
+    , storage_(std::move(storage))
+{
+    if (weights.size() != vertex_count_ * vertex_count_ || prev_edges.size() != weights.size()) {
+        throw std::invalid_argument("All-pairs table does not match the graph");
+    }
+}
+
+template <typename Weight, typename StoredWeight>
+Router<Weight, StoredWeight>::Router(const Graph& graph, std::span<const VertexId> sources, size_t thread_count)
+    : graph_(graph)
+    , vertex_count_(graph.GetVertexCount())
+    , source_rows_(vertex_count_, NO_ROW)
+{
+    if (graph.GetEdgeCount() >= NO_EDGE) {
+        throw std::length_error("Too many edges for the all-pairs table");
+    }
+    for (EdgeId edge_id = 0; edge_id < graph.GetEdgeCount(); ++edge_id) {
+        if (graph.GetEdge(edge_id).weight < ZERO_WEIGHT) {
+            throw std::domain_error("Edges' weights should be non-negative");
+        }
+    }
+    std::vector<VertexId> rows;
+    for (const VertexId source : sources) {
+        if (source >= vertex_count_) {
+            throw std::out_of_range("Vertex is out of range");
+        }
+        if (source_rows_[source] == NO_ROW) {
+            source_rows_[source] = rows.size();
+            rows.push_back(source);
+        }
+    }
+    weights_.assign(rows.size() * vertex_count_, NO_ROUTE);
+    prev_edges_.assign(rows.size() * vertex_count_, NO_EDGE);
+
+    // Строки независимы, потоки разбирают их из общего счётчика
+    std::atomic<size_t> next_row{0};
+    auto worker = [&] {
+        for (size_t row = next_row++; row < rows.size(); row = next_row++) {
+            SetRowFromTree(rows[row]);
+        }
+    };
+    thread_count = std::min(thread_count, rows.size());
+    {
+        std::vector<std::jthread> threads;
+        for (size_t i = 1; i < thread_count; ++i) {
+            threads.emplace_back(worker);
+        }
+        worker();
+    }
+    table_weights_ = weights_;
+    table_prev_edges_ = prev_edges_;
+}
+
+template <typename Weight, typename StoredWeight>
+void Router<Weight, StoredWeight>::Update(std::span<const std::optional<EdgeId>> edge_remap,
+                                          std::span<const EdgeId> inserted_edges) {
+    if (IsPartial()) {
+        throw std::logic_error("Partial all-pairs table cannot be updated");
+    }
+    const size_t old_count = vertex_count_;
+    const size_t new_count = graph_.GetVertexCount();
+    if (new_count < old_count) {
+        throw std::invalid_argument("Vertices cannot be removed from the all-pairs table");
+    }
+    if (graph_.GetEdgeCount() >= NO_EDGE) {
+        throw std::length_error("Too many edges for the all-pairs table");
+    }
+    for (const EdgeId edge_id : inserted_edges) {
+        if (graph_.GetEdge(edge_id).weight < ZERO_WEIGHT) {
+            throw std::domain_error("Edges' weights should be non-negative");
+        }
+    }
+
+    // Таблица переносится в новые массивы: она может быть внешней и не совпадать по размеру
+    std::vector<StoredWeight> weights(new_count * new_count, NO_ROUTE);
+    std::vector<StoredEdgeId> prev_edges(new_count * new_count, NO_EDGE);
+    std::vector<bool> exact_rows(new_count, false);
+    for (VertexId vertex_from = 0; vertex_from < old_count; ++vertex_from) {
+        for (VertexId vertex_to = 0; vertex_to < old_count; ++vertex_to) {
+            const size_t old_cell = vertex_from * old_count + vertex_to;
+            const size_t new_cell = vertex_from * new_count + vertex_to;
+            weights[new_cell] = table_weights_[old_cell];
+            const StoredEdgeId prev_edge = table_prev_edges_[old_cell];
+            if (prev_edge == NO_EDGE) {
+                continue;
+            }
+            if (const auto new_edge = edge_remap[prev_edge]) {
+                prev_edges[new_cell] = static_cast<StoredEdgeId>(*new_edge);
+            } else {
+                exact_rows[vertex_from] = true;
+            }
+        }
+    }
+    for (VertexId vertex = old_count; vertex < new_count; ++vertex) {
+        weights[vertex * new_count + vertex] = StoredWeight{};
+    }
+    vertex_count_ = new_count;
+    weights_ = std::move(weights);
+    prev_edges_ = std::move(prev_edges);
+    table_weights_ = weights_;
+    table_prev_edges_ = prev_edges_;
+    storage_.reset();
+
+    // Строки с удалёнными рёбрами в дереве путей считаются заново и дальше не релаксируются.
+    // Остальные строки точны для старого графа без удалённых рёбер
+    for (VertexId vertex_from = 0; vertex_from < new_count; ++vertex_from) {
+        if (exact_rows[vertex_from]) {
+            SetRowFromTree(vertex_from);
+        }
+    }
+
+    // Кратчайший путь через вставленные рёбра до первого из них проходит по старым рёбрам,
+    // поэтому достаточно релаксировать строки через начало каждого вставленного ребра
+    std::vector<VertexId> tails;
+    for (const EdgeId edge_id : inserted_edges) {
+        tails.push_back(graph_.GetEdge(edge_id).from);
+    }
+    std::ranges::sort(tails);
+    tails.erase(std::unique(tails.begin(), tails.end()), tails.end());
+    for (const VertexId tail : tails) {
+        if (!exact_rows[tail]) {
+            SetRowFromTree(tail);
+            exact_rows[tail] = true;
+        }
+        for (VertexId vertex_from = 0; vertex_from < new_count; ++vertex_from) {
+            if (!exact_rows[vertex_from]) {
+                RelaxRowsThroughVertex(tail, vertex_from, vertex_from + 1);
+            }
+        }
+    }
+}
+
+template <typename Weight, typename StoredWeight>
+std::optional<typename Router<Weight, StoredWeight>::RouteInfo> Router<Weight, StoredWeight>::BuildRoute(VertexId from,
+                                                                                                         VertexId to) const {
+    if (from >= vertex_count_ || to >= vertex_count_) {
+        throw std::out_of_range("Vertex is out of range");
+    }
+    if (Row(from) == NO_ROW) {
+        return BuildRouteFromTree(from, to);
+    }
+    if (table_weights_[Cell(from, to)] == NO_ROUTE) {
+        return std::nullopt;
+    }
+    std::vector<EdgeId> edges;
+    for (StoredEdgeId edge_id = table_prev_edges_[Cell(from, to)];
+         edge_id != NO_EDGE;
+         edge_id = table_prev_edges_[Cell(from, graph_.GetEdge(edge_id).from)])
+    {
+        edges.push_back(edge_id);
+    }
+    std::reverse(edges.begin(), edges.end());
+
+    Weight weight = table_weights_[Cell(from, to)];
+    if constexpr (!std::is_same_v<StoredWeight, Weight>) {
+        weight = ZERO_WEIGHT;
+        for (const EdgeId edge_id : edges) {
+            weight += graph_.GetEdge(edge_id).weight;
+        }
+    }
+
+    return RouteInfo{weight, std::move(edges)};
+}
+
+template <typename Weight, typename StoredWeight>
+std::optional<typename Router<Weight, StoredWeight>::RouteInfo>
+Router<Weight, StoredWeight>::BuildRouteFromTree(VertexId from, VertexId to) const {
+    const auto tree = BuildShortestPathTree(graph_, from);
+    if (!tree.reached[to]) {
+        return std::nullopt;
+    }
+    std::vector<EdgeId> edges;
+    for (EdgeId edge_id = tree.prev_edges[to]; edge_id != tree.NO_EDGE;
+         edge_id = tree.prev_edges[graph_.GetEdge(edge_id).from])
+    {
+        edges.push_back(edge_id);
+    }
+    std::reverse(edges.begin(), edges.end());
+    return RouteInfo{tree.weights[to], std::move(edges)};
+}
+
 }  // namespace graph
\ No newline at end of file
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "graph.h"
+
+#include <functional>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+// Полное дерево кратчайших путей из одной вершины: вес пути до каждой вершины
+// и последнее ребро этого пути (NO_EDGE для корня и недостижимых вершин)
+template <typename Weight>
+struct ShortestPathTree {
+    static constexpr EdgeId NO_EDGE = std::numeric_limits<EdgeId>::max();
+
+    std::vector<Weight> weights;
+    std::vector<EdgeId> prev_edges;
+    std::vector<bool> reached;
+};
+
+// Алгоритм Дейкстры без ранней остановки, O((V + E) log V)
+template <typename Weight>
+ShortestPathTree<Weight> BuildShortestPathTree(const DirectedWeightedGraph<Weight>& graph, VertexId from) {
+    using Tree = ShortestPathTree<Weight>;
+    using QueueItem = std::pair<Weight, VertexId>;
+
+    const size_t vertex_count = graph.GetVertexCount();
+    if (from >= vertex_count) {
+        throw std::out_of_range("Vertex is out of range");
+    }
+    Tree tree{std::vector<Weight>(vertex_count), std::vector<EdgeId>(vertex_count, Tree::NO_EDGE),
+              std::vector<bool>(vertex_count, false)};
+    std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>> queue;
+    tree.weights[from] = Weight{};
+    tree.reached[from] = true;
+    queue.emplace(Weight{}, from);
+
+    while (!queue.empty()) {
+        const auto [weight, vertex] = queue.top();
+        queue.pop();
+        if (tree.weights[vertex] < weight) {
+            continue;
+        }
+        graph.ForEachIncidentEdge(vertex, [&, weight = weight](EdgeId edge_id, VertexId edge_to, Weight edge_weight) {
+            const Weight candidate_weight = weight + edge_weight;
+            if (!tree.reached[edge_to] || candidate_weight < tree.weights[edge_to]) {
+                tree.weights[edge_to] = candidate_weight;
+                tree.prev_edges[edge_to] = edge_id;
+                tree.reached[edge_to] = true;
+                queue.emplace(candidate_weight, edge_to);
+            }
+        });
+    }
+    return tree;
+}
+
+}  // namespace graph
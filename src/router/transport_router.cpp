@@ -1,127 +1,706 @@
-#include "transport_router.h"
-
-#include <deque>
-#include <vector>
-#include <algorithm>
-
-namespace transport_router {
-	using namespace graph;
-	namespace detail {
-		static std::vector<const BusStop*> GetUniqueStop(const std::deque<Route>& routes) {
-			std::vector<const BusStop*> stops;
-			for (const Route& route : routes) {
-				std::ranges::copy(route.driving_route, std::back_inserter(stops));
-			}
-			std::ranges::sort(stops);
-			auto [it_del, last] = std::ranges::unique(stops);
-			stops.erase(it_del, last);
-			return stops;
-		}
-	} // namespace detail
-
-	TransportRouter::TransportRouter(const TransportCatalogue& catalogue)
-		: catalogue_{ catalogue } {
-	}
-
-	void TransportRouter::SetSetting(RoutingSetting settings) {
-		settings_ = std::move(settings);
-	}
-
-	void TransportRouter::Initialization() {
-		const std::deque<Route>& routes = catalogue_.GetRoutes();
-		auto unique_stops = detail::GetUniqueStop(routes);
-		map_ = DirectedWeightedGraph<Time>(unique_stops.size() * 2);
-		CreateEdges(unique_stops);
-		for (const auto& edge : edges_) {
-			map_.AddEdge(edge);
-		}
-
-		router_ = std::make_unique<Router<Time>>(map_);
-	}
-
-	std::optional<InfoBuildRoute> TransportRouter::BuildRoute(std::string_view from, std::string_view  to) const {
-		assert(router_ != nullptr);
-		InfoBuildRoute result;
-		auto from_ptr = catalogue_.GetStop(from);
-		auto to_ptr = catalogue_.GetStop(to);
-		if (!ref_vertex_.contains(from_ptr) || !ref_vertex_.contains(to_ptr)) {
-			return std::nullopt;
-		}
-
-		if (auto route = router_->BuildRoute(ref_vertex_.at(from_ptr).in, ref_vertex_.at(to_ptr).in)) {
-			for (const auto& edgeid : route.value().edges) {
-				result.route.push_back(ref_edge_.at(edgeid));
-			}
-			result.total_weight = route->weight;
-		} else {
-			return std::nullopt;
-		}
-
-		return result;
-	}
-
-	void TransportRouter::CreateEdges(const std::vector<const BusStop*>& stops) {
-		edges_.clear();
-		CreateWaitEdges(stops);
-		CreateBusEdges();
-	}
-
-	void TransportRouter::CreateWaitEdges(const std::vector<const BusStop*>& stops) {
-		VertexId counter = 0;
-		for (const BusStop* from : stops) {
-			VertexInfo stop_vertex{
-				.in = counter++,
-				.out = counter++
-			};
-			ref_vertex_[from] = stop_vertex;
-
-			Edge<Time> wait{
-				.from = stop_vertex.in,
-				.to = stop_vertex.out,
-				.weight = static_cast<Time>(settings_.bus_wait)
-			};
-
-			edges_.push_back(wait);
-			ref_edge_[edges_.size() - 1] = EdgeWait{ .stop = from, .time = wait.weight };
-		}
-	}
-	
-	void TransportRouter::CreateBusEdges() {
-		const auto& routes = catalogue_.GetRoutes();
-		for (const auto& route : routes) {
-			const auto& vec = route.driving_route;
-			for (auto it_from = vec.begin(); it_from != vec.end(); ++it_from) {
-				Time total_time = 0;
-				auto prev = it_from;
-				for (auto it_to = next(it_from); it_to != vec.end(); ++it_to) {
-					BusStopPair edge{ *prev, *it_to };
-					if (auto dist = catalogue_.GetStopsDistance(edge, !route.round_trip)) {
-						total_time += DistToTime(dist.value());
-					} else {
-						continue;
-					}
-					prev = it_to;
-
-					Edge<Time> bus{
-						.from = ref_vertex_[*it_from].out,
-						.to = ref_vertex_[*it_to].in,
-						.weight = total_time,
-					};
-					edges_.push_back(bus);
-					ref_edge_[edges_.size() - 1] = EdgeBus{
-						.route = &route,
-						.time = bus.weight,
-						.span_count = static_cast<int>(std::distance(it_from, it_to))
-					};
-				}
-			}
-		}
-	}
-
-	Time TransportRouter::DistToTime(size_t dist) const {
-		constexpr double MINUTES_PER_HOUR = 60;
-		constexpr double METERS_PER_KILOMETER = 1000;
-		return (dist * MINUTES_PER_HOUR) / (settings_.bus_velocity * METERS_PER_KILOMETER);
-	}
-} // namespace transport_router
-
+#include "transport_router.h"
+
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <exception>
+#include <span>
+#include <thread>
+#include <tuple>
+
+namespace transport_router {
+	using namespace graph;
+	namespace detail {
+		// Остановки маршрутов в порядке StopId без повторов
+		static std::vector<const BusStop*> GetUniqueStop(const TransportCatalogue& catalogue) {
+			std::vector<bool> used(catalogue.GetStopCount(), false);
+			for (const Route& route : catalogue.GetRoutes()) {
+				for (const BusStop* stop : route.driving_route) {
+					used[stop->id] = true;
+				}
+			}
+			std::vector<const BusStop*> stops;
+			for (StopId id = 0; id < used.size(); ++id) {
+				if (used[id]) {
+					stops.push_back(&catalogue.GetStopById(id));
+				}
+			}
+			return stops;
+		}
+
+		// Файл кэша: заголовок, рёбра графа, имена остановок в порядке вершин и в режиме
+		// all_pairs таблица весов и последних рёбер. Все секции выровнены на CACHE_ALIGNMENT,
+		// чтобы таблицу можно было читать прямо из отображённого в память файла
+		constexpr char CACHE_MAGIC[8] = { 'T', 'C', 'R', 'O', 'U', 'T', 'E', 'R' };
+		constexpr uint32_t CACHE_VERSION = 1;
+		constexpr size_t CACHE_ALIGNMENT = 8;
+
+		struct CacheHeader {
+			char magic[8];
+			uint32_t version;
+			uint32_t mode;
+			uint64_t key;
+			uint64_t vertex_count;
+			uint64_t edge_count;
+			uint64_t names_size;
+			uint64_t stored_weight_size; // 0, если таблицы нет
+		};
+
+		// Ребро ожидания: span_count == 0, ref - номер остановки.
+		// Ребро автобуса: ref - номер маршрута в TransportCatalogue::GetRoutes
+		struct CacheEdge {
+			double weight;
+			uint32_t from;
+			uint32_t to;
+			uint32_t ref;
+			int32_t span_count;
+		};
+
+		size_t AlignSize(size_t size) {
+			return (size + CACHE_ALIGNMENT - 1) / CACHE_ALIGNMENT * CACHE_ALIGNMENT;
+		}
+
+		void WritePadding(std::ostream& output, size_t size) {
+			static constexpr char ZEROS[CACHE_ALIGNMENT] = {};
+			output.write(ZEROS, static_cast<std::streamsize>(AlignSize(size) - size));
+		}
+
+		// Ребро вместе с его смыслом (StopId остановки ожидания или RouteId маршрута и число
+		// пролётов). По ключу рёбра старого и нового графа сопоставляются при обновлении
+		using EdgeKey = std::tuple<VertexId, VertexId, Time, uint32_t, int>;
+
+		std::vector<std::pair<EdgeKey, EdgeId>> GetSortedEdgeKeys(const std::vector<Edge<Time>>& edges,
+			const std::vector<EdgeInfo>& ref_edge) {
+			std::vector<std::pair<EdgeKey, EdgeId>> keys;
+			keys.reserve(edges.size());
+			for (EdgeId edge_id = 0; edge_id < edges.size(); ++edge_id) {
+				const Edge<Time>& edge = edges[edge_id];
+				const EdgeInfo& info = ref_edge[edge_id];
+				if (const auto* bus = std::get_if<EdgeBus>(&info)) {
+					keys.push_back({ { edge.from, edge.to, edge.weight, bus->route->id, bus->span_count }, edge_id });
+				} else {
+					keys.push_back({ { edge.from, edge.to, edge.weight, std::get<EdgeWait>(info).stop->id, 0 }, edge_id });
+				}
+			}
+			std::ranges::sort(keys);
+			return keys;
+		}
+
+		template <typename T>
+		T ReadValue(std::span<const std::byte> data, size_t offset) {
+			T value;
+			std::memcpy(&value, data.data() + offset, sizeof(T));
+			return value;
+		}
+	} // namespace detail
+
+	TransportRouter::TransportRouter(const TransportCatalogue& catalogue)
+		: catalogue_{ catalogue } {
+	}
+
+	void TransportRouter::SetSetting(RoutingSetting settings) {
+		settings_ = std::move(settings);
+		route_cache_.Reset(settings_.route_cache_size);
+	}
+
+	const RoutingSetting& TransportRouter::GetSetting() const {
+		return settings_;
+	}
+
+	void TransportRouter::SetQuerySources(std::vector<std::string> stops) {
+		query_sources_ = std::move(stops);
+	}
+
+	void TransportRouter::Initialization() {
+		std::call_once(initialized_flag_, [this] { InitializeRouting(); });
+	}
+
+	// Запросы константны, а граф и маршрутизатор строятся при первом из них ровно один раз,
+	// в том числе при одновременных запросах из нескольких потоков
+	void TransportRouter::EnsureInitialized() const {
+		std::call_once(initialized_flag_, [this] { const_cast<TransportRouter*>(this)->InitializeRouting(); });
+	}
+
+	void TransportRouter::InitializeRouting() {
+		initialized_ = true;
+		route_cache_.Clear();
+		if (settings_.mode == RouterMode::RAPTOR) {
+			CreateRaptorRouter();
+			return;
+		}
+		if (!settings_.cache_file.empty() && LoadCache()) {
+			return;
+		}
+		stop_vertices_.clear();
+		routed_stops_.clear();
+		vertex_stops_.clear();
+		BuildGraph();
+		CreateRouter();
+		if (!settings_.cache_file.empty()) {
+			SaveCache();
+		}
+	}
+
+	// Граф перестраивается за O(E log E), таблица all_pairs сохраняет строки, которых изменения
+	// не коснулись, остальные режимы заново создаются над новым графом
+	void TransportRouter::Update() {
+		route_cache_.Clear();
+		// До первого запроса обновлять нечего: граф построится по текущему каталогу
+		if (!initialized_) {
+			return;
+		}
+		if (settings_.mode == RouterMode::RAPTOR) {
+			CreateRaptorRouter();
+			return;
+		}
+		assert(router_ != nullptr);
+		std::vector<Edge<Time>> old_edges = std::move(edges_);
+		std::vector<EdgeInfo> old_ref_edge = std::move(ref_edge_);
+		BuildGraph();
+		if (settings_.mode != RouterMode::ALL_PAIRS || UsesPartialTable()) {
+			CreateRouter();
+			return;
+		}
+
+		const auto old_keys = detail::GetSortedEdgeKeys(old_edges, old_ref_edge);
+		const auto new_keys = detail::GetSortedEdgeKeys(edges_, ref_edge_);
+		std::vector<std::optional<EdgeId>> edge_remap(old_edges.size());
+		std::vector<EdgeId> inserted_edges;
+		auto old_it = old_keys.begin();
+		for (const auto& [key, edge_id] : new_keys) {
+			while (old_it != old_keys.end() && old_it->first < key) {
+				++old_it;
+			}
+			if (old_it != old_keys.end() && old_it->first == key) {
+				edge_remap[old_it->second] = edge_id;
+				++old_it;
+			} else {
+				inserted_edges.push_back(edge_id);
+			}
+		}
+
+		if (settings_.compact_table) {
+			UpdateAllPairsRouter<float>(edge_remap, inserted_edges);
+		} else {
+			UpdateAllPairsRouter<Time>(edge_remap, inserted_edges);
+		}
+	}
+
+	// Режим RAPTOR не строит граф: индекс маршрутов строится за O(суммы длин маршрутов)
+	void TransportRouter::CreateRaptorRouter() {
+		raptor_ = std::make_unique<RaptorRouter>(catalogue_, static_cast<Time>(settings_.bus_wait),
+			[this](size_t dist) { return DistToTime(dist); });
+	}
+
+	void TransportRouter::BuildGraph() {
+		auto unique_stops = detail::GetUniqueStop(catalogue_);
+		AssignVertices(unique_stops);
+		map_ = DirectedWeightedGraph<Time>(vertex_stops_.size());
+		CreateEdges(unique_stops);
+		for (const auto& edge : edges_) {
+			map_.AddEdge(edge);
+		}
+		map_.Freeze();
+	}
+
+	// Номера вершин остановок не меняются между перестроениями графа: новые остановки получают
+	// номера после существующих, выбывшие из всех маршрутов откладываются до возвращения
+	void TransportRouter::AssignVertices(const std::vector<const BusStop*>& stops) {
+		stop_vertices_.resize(catalogue_.GetStopCount(), VertexInfo{ .in = NO_VERTEX, .out = NO_VERTEX });
+		routed_stops_.assign(catalogue_.GetStopCount(), false);
+		for (const BusStop* stop : stops) {
+			VertexInfo& stop_vertex = stop_vertices_[stop->id];
+			if (stop_vertex.in == NO_VERTEX) {
+				stop_vertex = VertexInfo{
+					.in = vertex_stops_.size(),
+					.out = vertex_stops_.size() + 1
+				};
+				vertex_stops_.push_back(stop);
+				vertex_stops_.push_back(stop);
+			}
+			routed_stops_[stop->id] = true;
+		}
+	}
+
+	const VertexInfo* TransportRouter::FindVertices(const BusStop* stop) const {
+		if (stop == nullptr || stop->id >= routed_stops_.size() || !routed_stops_[stop->id]) {
+			return nullptr;
+		}
+		return &stop_vertices_[stop->id];
+	}
+
+	void TransportRouter::CreateRouter() {
+		switch (settings_.mode) {
+		case RouterMode::ALL_PAIRS:
+			if (settings_.compact_table) {
+				CreateAllPairsRouter<float>();
+			} else {
+				CreateAllPairsRouter<Time>();
+			}
+			break;
+		case RouterMode::DIJKSTRA:
+			router_ = std::make_unique<DijkstraRouter<Time>>(map_);
+			break;
+		case RouterMode::BIDIRECTIONAL_DIJKSTRA:
+			router_ = std::make_unique<BidirectionalDijkstraRouter<Time>>(map_);
+			break;
+		case RouterMode::CONTRACTION_HIERARCHY:
+			router_ = std::make_unique<ContractionHierarchy<Time>>(map_);
+			break;
+		case RouterMode::A_STAR:
+			router_ = std::make_unique<AStarRouter<Time>>(map_,
+				[this, time_per_meter = ComputeTimePerMeter()](VertexId vertex, VertexId to) {
+					return geo::ComputeDistance(vertex_stops_[vertex]->unit_vector, vertex_stops_[to]->unit_vector) * time_per_meter;
+				});
+			break;
+		case RouterMode::RAPTOR:
+			// RAPTOR обходится без графа: его маршрутизатор создаёт CreateRaptorRouter
+			assert(false);
+			break;
+		}
+	}
+
+	// Частичная таблица не сохраняется в файл: набор строк зависит от запросов, а не от исходных данных
+	bool TransportRouter::UsesPartialTable() const {
+		return settings_.mode == RouterMode::ALL_PAIRS && settings_.cache_file.empty() && !query_sources_.empty();
+	}
+
+	// Таблица всех пар растёт как V^2, поэтому её размер пишется в лог для оценки памяти сервера
+	template <typename StoredWeight>
+	void TransportRouter::CreateAllPairsRouter() {
+		std::unique_ptr<Router<Time, StoredWeight>> router;
+		if (UsesPartialTable()) {
+			std::vector<VertexId> sources;
+			for (const std::string& name : query_sources_) {
+				if (const VertexInfo* stop_vertex = FindVertices(catalogue_.GetStop(name))) {
+					sources.push_back(stop_vertex->in);
+				}
+			}
+			router = std::make_unique<Router<Time, StoredWeight>>(map_, std::span<const VertexId>(sources), GetThreadCount());
+		} else {
+			router = std::make_unique<Router<Time, StoredWeight>>(map_, GetThreadCount());
+		}
+		std::clog << "all_pairs table: " << map_.GetVertexCount() << " vertices, "
+			<< Router<Time, StoredWeight>::BYTES_PER_PAIR << " bytes per pair, "
+			<< router->GetTableBytes() << " bytes total" << std::endl;
+		router_ = std::move(router);
+	}
+
+	// Таблица не копируется: Router читает её прямо из файла и держит файл открытым
+	template <typename StoredWeight>
+	void TransportRouter::LoadAllPairsRouter(std::shared_ptr<const MappedFile> file, size_t offset) {
+		using TableRouter = Router<Time, StoredWeight>;
+		const size_t cell_count = map_.GetVertexCount() * map_.GetVertexCount();
+		const std::byte* data = file->GetData().data() + offset;
+		std::span weights{ reinterpret_cast<const StoredWeight*>(data), cell_count };
+		std::span prev_edges{
+			reinterpret_cast<const typename TableRouter::StoredEdgeId*>(data + detail::AlignSize(cell_count * sizeof(StoredWeight))),
+			cell_count
+		};
+		router_ = std::make_unique<TableRouter>(map_, weights, prev_edges, std::move(file));
+	}
+
+	template <typename StoredWeight>
+	void TransportRouter::UpdateAllPairsRouter(const std::vector<std::optional<EdgeId>>& edge_remap,
+		const std::vector<EdgeId>& inserted_edges) {
+		dynamic_cast<Router<Time, StoredWeight>&>(*router_).Update(edge_remap, inserted_edges);
+	}
+
+	template <typename StoredWeight>
+	void TransportRouter::WriteAllPairsTable(std::ostream& output) const {
+		const auto& router = dynamic_cast<const Router<Time, StoredWeight>&>(*router_);
+		const auto weights = router.GetWeights();
+		const auto prev_edges = router.GetPrevEdges();
+		output.write(reinterpret_cast<const char*>(weights.data()), static_cast<std::streamsize>(weights.size_bytes()));
+		detail::WritePadding(output, weights.size_bytes());
+		output.write(reinterpret_cast<const char*>(prev_edges.data()), static_cast<std::streamsize>(prev_edges.size_bytes()));
+	}
+
+	// Кэш принимается, только если совпадают версия формата, режим и хэш исходных данных.
+	// Любое несоответствие означает полное перестроение
+	bool TransportRouter::LoadCache() {
+		std::shared_ptr<const MappedFile> file = MappedFile::Open(settings_.cache_file);
+		if (!file) {
+			return false;
+		}
+		const std::span<const std::byte> data = file->GetData();
+		if (data.size() < sizeof(detail::CacheHeader)) {
+			return false;
+		}
+		const auto header = detail::ReadValue<detail::CacheHeader>(data, 0);
+		const size_t stored_weight_size = settings_.mode != RouterMode::ALL_PAIRS ? 0
+			: settings_.compact_table ? sizeof(float) : sizeof(Time);
+		if (!std::ranges::equal(header.magic, detail::CACHE_MAGIC) || header.version != detail::CACHE_VERSION
+			|| header.key != settings_.cache_key || header.mode != static_cast<uint32_t>(settings_.mode)
+			|| header.stored_weight_size != stored_weight_size || header.vertex_count % 2 != 0) {
+			return false;
+		}
+
+		// Размеры из заголовка ограничиваются до вычисления смещений: произведения и суммы
+		// повреждённых значений иначе переполнились бы и прошли сверку с размером файла
+		if (header.vertex_count > 2 * catalogue_.GetStopCount() || header.edge_count > data.size() / sizeof(detail::CacheEdge)
+			|| header.names_size > data.size()) {
+			return false;
+		}
+		const size_t vertex_count = header.vertex_count;
+		size_t cell_count = 0;
+		if (stored_weight_size != 0) {
+			const size_t bytes_per_pair = stored_weight_size + sizeof(uint32_t);
+			if (vertex_count > data.size() / bytes_per_pair / std::max<size_t>(vertex_count, 1)) {
+				return false;
+			}
+			cell_count = vertex_count * vertex_count;
+		}
+		const size_t edges_offset = detail::AlignSize(sizeof(detail::CacheHeader));
+		const size_t names_offset = edges_offset + detail::AlignSize(header.edge_count * sizeof(detail::CacheEdge));
+		const size_t table_offset = names_offset + header.names_size;
+		const size_t table_size = stored_weight_size == 0 ? 0
+			: detail::AlignSize(cell_count * stored_weight_size) + cell_count * sizeof(uint32_t);
+		if (data.size() != table_offset + table_size) {
+			return false;
+		}
+
+		std::vector<const BusStop*> stops;
+		for (size_t offset = names_offset; stops.size() < vertex_count / 2;) {
+			if (offset + sizeof(uint32_t) > table_offset) {
+				return false;
+			}
+			const auto length = detail::ReadValue<uint32_t>(data, offset);
+			offset += sizeof(uint32_t);
+			if (offset + length > table_offset) {
+				return false;
+			}
+			const BusStop* stop = catalogue_.GetStop({ reinterpret_cast<const char*>(data.data() + offset), length });
+			if (stop == nullptr) {
+				return false;
+			}
+			stops.push_back(stop);
+			offset += length;
+		}
+
+		std::vector<Edge<Time>> edges;
+		std::vector<EdgeInfo> ref_edge;
+		edges.reserve(header.edge_count);
+		for (size_t i = 0; i < header.edge_count; ++i) {
+			const auto edge = detail::ReadValue<detail::CacheEdge>(data, edges_offset + i * sizeof(detail::CacheEdge));
+			if (edge.from >= vertex_count || edge.to >= vertex_count
+				|| (edge.span_count == 0 ? edge.ref >= stops.size() : edge.ref >= catalogue_.GetRouteCount())) {
+				return false;
+			}
+			edges.push_back({ .from = edge.from, .to = edge.to, .weight = edge.weight });
+			if (edge.span_count == 0) {
+				ref_edge.push_back(EdgeWait{ .stop = stops[edge.ref], .time = edge.weight });
+			} else {
+				ref_edge.push_back(EdgeBus{ .route = &catalogue_.GetRouteById(edge.ref), .time = edge.weight, .span_count = edge.span_count });
+			}
+		}
+
+		edges_ = std::move(edges);
+		ref_edge_ = std::move(ref_edge);
+		stop_vertices_.assign(catalogue_.GetStopCount(), VertexInfo{ .in = NO_VERTEX, .out = NO_VERTEX });
+		routed_stops_.assign(catalogue_.GetStopCount(), false);
+		vertex_stops_.assign(vertex_count, nullptr);
+		for (size_t i = 0; i < stops.size(); ++i) {
+			const VertexInfo stop_vertex{ .in = 2 * i, .out = 2 * i + 1 };
+			stop_vertices_[stops[i]->id] = stop_vertex;
+			routed_stops_[stops[i]->id] = true;
+			vertex_stops_[stop_vertex.in] = stops[i];
+			vertex_stops_[stop_vertex.out] = stops[i];
+		}
+		map_ = DirectedWeightedGraph<Time>(vertex_count);
+		for (const auto& edge : edges_) {
+			map_.AddEdge(edge);
+		}
+		map_.Freeze();
+
+		if (settings_.mode != RouterMode::ALL_PAIRS) {
+			CreateRouter();
+		} else if (settings_.compact_table) {
+			LoadAllPairsRouter<float>(std::move(file), table_offset);
+		} else {
+			LoadAllPairsRouter<Time>(std::move(file), table_offset);
+		}
+		std::clog << "router cache: loaded " << settings_.cache_file << std::endl;
+		return true;
+	}
+
+	// Файл пишется во временный и переименовывается, чтобы параллельный запуск
+	// не прочитал его недописанным
+	void TransportRouter::SaveCache() const {
+		std::string names;
+		for (VertexId vertex = 0; vertex < vertex_stops_.size(); vertex += 2) {
+			const std::string& name = vertex_stops_[vertex]->name;
+			const auto length = static_cast<uint32_t>(name.size());
+			names.append(reinterpret_cast<const char*>(&length), sizeof(length));
+			names.append(name);
+		}
+
+		detail::CacheHeader header{};
+		std::ranges::copy(detail::CACHE_MAGIC, header.magic);
+		header.version = detail::CACHE_VERSION;
+		header.mode = static_cast<uint32_t>(settings_.mode);
+		header.key = settings_.cache_key;
+		header.vertex_count = map_.GetVertexCount();
+		header.edge_count = edges_.size();
+		header.names_size = detail::AlignSize(names.size());
+		header.stored_weight_size = settings_.mode != RouterMode::ALL_PAIRS ? 0
+			: settings_.compact_table ? sizeof(float) : sizeof(Time);
+
+		const std::string temp_file = settings_.cache_file + ".tmp";
+		{
+			std::ofstream output(temp_file, std::ios::binary | std::ios::trunc);
+			output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			detail::WritePadding(output, sizeof(header));
+			for (EdgeId edge_id = 0; edge_id < edges_.size(); ++edge_id) {
+				const Edge<Time>& edge = edges_[edge_id];
+				detail::CacheEdge record{
+					.weight = edge.weight,
+					.from = static_cast<uint32_t>(edge.from),
+					.to = static_cast<uint32_t>(edge.to),
+					.ref = 0,
+					.span_count = 0
+				};
+				if (const auto* bus = std::get_if<EdgeBus>(&ref_edge_[edge_id])) {
+					record.ref = bus->route->id;
+					record.span_count = bus->span_count;
+				} else {
+					record.ref = static_cast<uint32_t>(edge.from / 2);
+				}
+				output.write(reinterpret_cast<const char*>(&record), sizeof(record));
+			}
+			detail::WritePadding(output, edges_.size() * sizeof(detail::CacheEdge));
+			output.write(names.data(), static_cast<std::streamsize>(names.size()));
+			detail::WritePadding(output, names.size());
+			if (settings_.mode == RouterMode::ALL_PAIRS && settings_.compact_table) {
+				WriteAllPairsTable<float>(output);
+			} else if (settings_.mode == RouterMode::ALL_PAIRS) {
+				WriteAllPairsTable<Time>(output);
+			}
+			if (!output) {
+				std::clog << "router cache: failed to write " << temp_file << std::endl;
+				return;
+			}
+		}
+		std::error_code error;
+		std::filesystem::rename(temp_file, settings_.cache_file, error);
+		if (error) {
+			std::clog << "router cache: failed to replace " << settings_.cache_file << ": " << error.message() << std::endl;
+			return;
+		}
+		std::clog << "router cache: saved " << settings_.cache_file << std::endl;
+	}
+
+	// Повторные запросы той же пары остановок отдаются из кэша без поиска и сборки элементов
+	std::optional<InfoBuildRoute> TransportRouter::BuildRoute(std::string_view from, std::string_view  to) const {
+		EnsureInitialized();
+		const BusStopPair key{ catalogue_.GetStop(from), catalogue_.GetStop(to) };
+		if (settings_.route_cache_size == 0) {
+			return ComputeRoute(key.first, key.second);
+		}
+		if (auto cached = route_cache_.Get(key)) {
+			return std::move(*cached);
+		}
+		auto result = ComputeRoute(key.first, key.second);
+		route_cache_.Put(key, result);
+		return result;
+	}
+
+	CacheStats TransportRouter::GetRouteCacheStats() const {
+		return route_cache_.GetStats();
+	}
+
+	std::optional<InfoBuildRoute> TransportRouter::ComputeRoute(const BusStop* from_ptr, const BusStop* to_ptr) const {
+		InfoBuildRoute result;
+		if (raptor_ != nullptr) {
+			return BuildRaptorRoute(from_ptr, to_ptr);
+		}
+		assert(router_ != nullptr);
+		const VertexInfo* from_vertex = FindVertices(from_ptr);
+		const VertexInfo* to_vertex = FindVertices(to_ptr);
+		if (from_vertex == nullptr || to_vertex == nullptr) {
+			return std::nullopt;
+		}
+
+		if (auto route = router_->BuildRoute(from_vertex->in, to_vertex->in)) {
+			for (const auto& edgeid : route.value().edges) {
+				result.route.push_back(ref_edge_[edgeid]);
+			}
+			result.total_weight = route->weight;
+			result.stats = route->stats;
+		} else {
+			return std::nullopt;
+		}
+
+		return result;
+	}
+
+	// Исключение из любого потока останавливает раздачу строк и передаётся вызывающему
+	std::vector<std::vector<std::optional<Time>>> TransportRouter::BuildMatrix(const std::vector<std::string>& origins,
+		const std::vector<std::string>& destinations, size_t thread_count) const {
+		EnsureInitialized();
+		std::vector<const BusStop*> destination_stops;
+		for (const std::string& name : destinations) {
+			destination_stops.push_back(catalogue_.GetStop(name));
+		}
+
+		std::vector<std::vector<std::optional<Time>>> result(origins.size());
+		std::atomic<size_t> next_origin{ 0 };
+		std::exception_ptr error;
+		std::mutex error_mutex;
+		auto worker = [&] {
+			try {
+				for (size_t i = next_origin++; i < origins.size(); i = next_origin++) {
+					result[i] = BuildMatrixRow(catalogue_.GetStop(origins[i]), destination_stops);
+				}
+			} catch (...) {
+				std::lock_guard guard(error_mutex);
+				if (!error) {
+					error = std::current_exception();
+				}
+				next_origin = origins.size();
+			}
+		};
+		thread_count = std::min(thread_count > 0 ? thread_count : GetThreadCount(), origins.size());
+		{
+			std::vector<std::jthread> threads;
+			for (size_t i = 1; i < thread_count; ++i) {
+				threads.emplace_back(worker);
+			}
+			worker();
+		}
+		if (error) {
+			std::rethrow_exception(error);
+		}
+		return result;
+	}
+
+	std::vector<std::optional<Time>> TransportRouter::BuildMatrixRow(const BusStop* from,
+		const std::vector<const BusStop*>& destinations) const {
+		if (raptor_ != nullptr) {
+			return raptor_->BuildTimes(from, destinations);
+		}
+		assert(router_ != nullptr);
+		std::vector<std::optional<Time>> result(destinations.size());
+		const VertexInfo* from_vertex = FindVertices(from);
+		if (from_vertex == nullptr) {
+			return result;
+		}
+
+		std::vector<VertexId> targets;
+		std::vector<size_t> target_columns;
+		for (size_t i = 0; i < destinations.size(); ++i) {
+			if (const VertexInfo* to_vertex = FindVertices(destinations[i])) {
+				targets.push_back(to_vertex->in);
+				target_columns.push_back(i);
+			}
+		}
+		const auto weights = router_->BuildWeights(from_vertex->in, targets);
+		for (size_t i = 0; i < weights.size(); ++i) {
+			result[target_columns[i]] = weights[i];
+		}
+		return result;
+	}
+
+	// Каждая поездка раскладывается в те же элементы, что даёт поиск по графу: ожидание и автобус
+	std::optional<InfoBuildRoute> TransportRouter::BuildRaptorRoute(const BusStop* from, const BusStop* to) const {
+		auto journey = raptor_->BuildRoute(from, to);
+		if (!journey) {
+			return std::nullopt;
+		}
+		InfoBuildRoute result{ .route{}, .total_weight = journey->total_time, .stats = journey->stats };
+		for (const RaptorRouter::Leg& leg : journey->legs) {
+			result.route.push_back(EdgeWait{ .stop = leg.route->driving_route[leg.board], .time = static_cast<Time>(settings_.bus_wait) });
+			result.route.push_back(EdgeBus{ .route = leg.route, .time = leg.time, .span_count = static_cast<int>(leg.alight - leg.board) });
+		}
+		return result;
+	}
+
+	void TransportRouter::CreateEdges(const std::vector<const BusStop*>& stops) {
+		edges_.clear();
+		ref_edge_.clear();
+		CreateWaitEdges(stops);
+		CreateBusEdges();
+	}
+
+	void TransportRouter::CreateWaitEdges(const std::vector<const BusStop*>& stops) {
+		for (const BusStop* from : stops) {
+			const VertexInfo& stop_vertex = stop_vertices_[from->id];
+
+			Edge<Time> wait{
+				.from = stop_vertex.in,
+				.to = stop_vertex.out,
+				.weight = static_cast<Time>(settings_.bus_wait)
+			};
+
+			edges_.push_back(wait);
+			ref_edge_.push_back(EdgeWait{ .stop = from, .time = wait.weight });
+		}
+	}
+	
+	void TransportRouter::CreateBusEdges() {
+		const auto& routes = catalogue_.GetRoutes();
+		for (const auto& route : routes) {
+			const auto& vec = route.driving_route;
+			for (auto it_from = vec.begin(); it_from != vec.end(); ++it_from) {
+				Time total_time = 0;
+				auto prev = it_from;
+				for (auto it_to = next(it_from); it_to != vec.end(); ++it_to) {
+					if (auto dist = catalogue_.GetStopsDistance((*prev)->id, (*it_to)->id, !route.round_trip)) {
+						total_time += DistToTime(dist.value());
+					} else {
+						continue;
+					}
+					prev = it_to;
+
+					Edge<Time> bus{
+						.from = stop_vertices_[(*it_from)->id].out,
+						.to = stop_vertices_[(*it_to)->id].in,
+						.weight = total_time,
+					};
+					edges_.push_back(bus);
+					ref_edge_.push_back(EdgeBus{
+						.route = &route,
+						.time = bus.weight,
+						.span_count = static_cast<int>(std::distance(it_from, it_to))
+					});
+				}
+			}
+		}
+	}
+
+	Time TransportRouter::DistToTime(size_t dist) const {
+		constexpr double MINUTES_PER_HOUR = 60;
+		constexpr double METERS_PER_KILOMETER = 1000;
+		return (dist * MINUTES_PER_HOUR) / (settings_.bus_velocity * METERS_PER_KILOMETER);
+	}
+
+	size_t TransportRouter::GetThreadCount() const {
+		if (settings_.threads > 0) {
+			return settings_.threads;
+		}
+		return std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	// Нижняя граница времени в пути на метр расстояния по сфере: минимум по всем рёбрам графа.
+	// Дорожное расстояние в исходных данных может быть короче расстояния по сфере, поэтому
+	// оценка строится по фактическим рёбрам, а не по bus_velocity. По неравенству треугольника
+	// время любого пути не меньше расстояния по сфере между концами, умноженного на эту величину
+	Time TransportRouter::ComputeTimePerMeter() const {
+		// Запас компенсирует погрешность округления в geo::ComputeDistance
+		constexpr double SAFETY_FACTOR = 0.999;
+		std::optional<Time> result;
+		for (const auto& edge : edges_) {
+			const double distance = geo::ComputeDistance(vertex_stops_[edge.from]->unit_vector, vertex_stops_[edge.to]->unit_vector);
+			if (distance > 0 && (!result || edge.weight / distance < *result)) {
+				result = edge.weight / distance;
+			}
+		}
+		return result.value_or(0) * SAFETY_FACTOR;
+	}
+} // namespace transport_router
+
@@ -1,69 +1,155 @@
-#pragma once
-
-#include "router.h"
-#include "domain.h"
-#include "request_handler.h"
-
-#include <memory>
-#include <optional>
-#include <variant>
-#include <unordered_map>
-#include <string_view>
-
-namespace transport_router {
-	using Time = double;
-
-	struct RoutingSetting {
-		int bus_wait = 0;
-		double bus_velocity = 0;
-	};
-
-	struct VertexInfo {
-		graph::VertexId in;
-		graph::VertexId out;
-	};
-	
-	struct EdgeBus {
-		const Route* route = nullptr;
-		Time time = 0;
-		int span_count = 0;
-	};
-
-	struct EdgeWait {
-		const BusStop* stop = nullptr;
-		Time time = 0;
-	};
-
-	using EdgeInfo = std::variant<EdgeBus, EdgeWait>;
-
-	struct InfoBuildRoute {
-		std::vector<EdgeInfo> route;
-		Time total_weight = 0;
-	};
-
-	class TransportRouter {
-	public:
-		TransportRouter(const TransportCatalogue& catalogue);
-
-		void SetSetting(RoutingSetting settings);
-		void Initialization();
-		std::optional<InfoBuildRoute> BuildRoute(std::string_view from, std::string_view  to) const;
-
-	private:
-		const TransportCatalogue& catalogue_;
-		RoutingSetting settings_;
-		std::unique_ptr<graph::Router<Time>> router_;
-
-		graph::DirectedWeightedGraph<Time> map_;
-		std::vector<graph::Edge<Time>> edges_;
-
-		std::unordered_map<const BusStop*, VertexInfo> ref_vertex_;
-		std::unordered_map<graph::EdgeId, EdgeInfo> ref_edge_;
-
-	private:
-		void CreateEdges(const std::vector<const BusStop*>& stops);
-		void CreateWaitEdges(const std::vector<const BusStop*>& stops);
-		void CreateBusEdges();
-		Time DistToTime(size_t dist) const;
-	};
+#pragma once
+
+#include "router.h"
+#include "dijkstra_router.h"
+#include "bidirectional_dijkstra_router.h"
+#include "contraction_hierarchy.h"
+#include "astar_router.h"
+#include "mapped_file.h"
+#include "raptor_router.h"
+#include "lru_cache.h"
+#include "domain.h"
+#include "request_handler.h"
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <variant>
+#include <string>
+#include <string_view>
+
+namespace transport_router {
+	using Time = double;
+
+	// Алгоритм поиска маршрута
+	enum class RouterMode {
+		DIJKSTRA,               // поиск в момент запроса, O(V + E) памяти
+		ALL_PAIRS,              // предрасчёт всех пар, O(V^2) памяти, только для небольших сетей
+		CONTRACTION_HIERARCHY,  // предрасчёт иерархии сжатия, быстрый двунаправленный запрос
+		A_STAR,                 // поиск A* с оценкой по расстоянию между остановками на сфере
+		BIDIRECTIONAL_DIJKSTRA, // встречный поиск Дейкстры из обеих остановок
+		RAPTOR                  // поиск по маршрутам раундами без построения графа
+	};
+
+	struct RoutingSetting {
+		int bus_wait = 0;
+		double bus_velocity = 0;
+		RouterMode mode = RouterMode::DIJKSTRA;
+		bool report_stats = false; // добавлять статистику поиска в ответ на запрос Route
+		size_t threads = 0;        // потоки предрасчёта и запросов RouteMatrix, 0 - по числу ядер
+		bool compact_table = false; // хранить веса таблицы всех пар во float
+		size_t route_cache_size = 0; // число ответов Route в кэше, 0 - без кэша
+		std::string cache_file{};    // файл с построенным маршрутизатором, пустая строка - без кэша
+		uint64_t cache_key = 0;      // хэш исходных данных, при несовпадении кэш перестраивается
+	};
+
+	struct VertexInfo {
+		graph::VertexId in;
+		graph::VertexId out;
+	};
+	
+	struct EdgeBus {
+		const Route* route = nullptr;
+		Time time = 0;
+		int span_count = 0;
+	};
+
+	struct EdgeWait {
+		const BusStop* stop = nullptr;
+		Time time = 0;
+	};
+
+	using EdgeInfo = std::variant<EdgeBus, EdgeWait>;
+
+	struct InfoBuildRoute {
+		std::vector<EdgeInfo> route;
+		Time total_weight = 0;
+		graph::SearchStats stats;
+	};
+
+	struct StopPairHasher {
+		size_t operator()(const BusStopPair& stops) const {
+			const size_t first = std::hash<const BusStop*>{}(stops.first);
+			const size_t second = std::hash<const BusStop*>{}(stops.second);
+			return first ^ (second + 0x9e3779b97f4a7c15ull + (first << 6) + (first >> 2));
+		}
+	};
+
+	class TransportRouter {
+	public:
+		TransportRouter(const TransportCatalogue& catalogue);
+
+		void SetSetting(RoutingSetting settings);
+		const RoutingSetting& GetSetting() const;
+		// Начальные остановки предстоящих запросов: таблица all_pairs без файла кэша
+		// строится только из их строк
+		void SetQuerySources(std::vector<std::string> stops);
+		// Строит граф и маршрутизатор сразу. Без вызова они строятся при первом запросе
+		void Initialization();
+		// Применяет изменения каталога после Initialization: добавление и удаление маршрутов,
+		// изменение расстояний между остановками. Ответы совпадают с полным перестроением
+		void Update();
+		std::optional<InfoBuildRoute> BuildRoute(std::string_view from, std::string_view  to) const;
+		// Счётчики кэша ответов Route (ёмкость задаёт route_cache_size)
+		CacheStats GetRouteCacheStats() const;
+		// Матрица времён в пути: [i][j] - от origins[i] до destinations[j], nullopt - маршрута нет.
+		// Поиск из каждой начальной остановки выполняется один раз на все конечные,
+		// начальные остановки распределяются по thread_count потокам, 0 - по настройке threads.
+		// Вызов из уже параллельного кода передаёт 1, чтобы не запускать вложенные потоки
+		std::vector<std::vector<std::optional<Time>>> BuildMatrix(const std::vector<std::string>& origins,
+			const std::vector<std::string>& destinations, size_t thread_count = 0) const;
+
+	private:
+		const TransportCatalogue& catalogue_;
+		RoutingSetting settings_;
+		std::vector<std::string> query_sources_;
+		mutable std::once_flag initialized_flag_;
+		bool initialized_ = false;
+		std::unique_ptr<graph::RouterBase<Time>> router_;
+		std::unique_ptr<RaptorRouter> raptor_;
+		mutable LruCache<BusStopPair, std::optional<InfoBuildRoute>, StopPairHasher> route_cache_;
+
+		graph::DirectedWeightedGraph<Time> map_;
+		std::vector<graph::Edge<Time>> edges_;
+
+		static constexpr graph::VertexId NO_VERTEX = std::numeric_limits<graph::VertexId>::max();
+		// Вершины остановок по StopId, NO_VERTEX - ещё не назначены. Остановка, выбывшая
+		// из всех маршрутов, сохраняет вершины до возвращения, но не входит в routed_stops_
+		std::vector<VertexInfo> stop_vertices_;
+		std::vector<bool> routed_stops_;
+		std::vector<EdgeInfo> ref_edge_;           // по EdgeId
+		std::vector<const BusStop*> vertex_stops_; // по VertexId
+
+	private:
+		void EnsureInitialized() const;
+		void InitializeRouting();
+		bool UsesPartialTable() const;
+		void BuildGraph();
+		void AssignVertices(const std::vector<const BusStop*>& stops);
+		// Вершины остановки из маршрутов текущего графа, nullptr - остановки в графе нет
+		const VertexInfo* FindVertices(const BusStop* stop) const;
+		void CreateRouter();
+		void CreateRaptorRouter();
+		std::optional<InfoBuildRoute> ComputeRoute(const BusStop* from, const BusStop* to) const;
+		std::optional<InfoBuildRoute> BuildRaptorRoute(const BusStop* from, const BusStop* to) const;
+		std::vector<std::optional<Time>> BuildMatrixRow(const BusStop* from, const std::vector<const BusStop*>& destinations) const;
+		bool LoadCache();
+		void SaveCache() const;
+		void CreateEdges(const std::vector<const BusStop*>& stops);
+		void CreateWaitEdges(const std::vector<const BusStop*>& stops);
+		void CreateBusEdges();
+		Time DistToTime(size_t dist) const;
+		Time ComputeTimePerMeter() const;
+		size_t GetThreadCount() const;
+		template <typename StoredWeight>
+		void CreateAllPairsRouter();
+		template <typename StoredWeight>
+		void LoadAllPairsRouter(std::shared_ptr<const MappedFile> file, size_t offset);
+		template <typename StoredWeight>
+		void UpdateAllPairsRouter(const std::vector<std::optional<graph::EdgeId>>& edge_remap, const std::vector<graph::EdgeId>& inserted_edges);
+		template <typename StoredWeight>
+		void WriteAllPairsTable(std::ostream& output) const;
+	};
 } // namespace transport_router
\ No newline at end of file
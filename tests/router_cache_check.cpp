@@ -0,0 +1,183 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "transport_catalogue.h"
+#include "transport_router.h"
+
+// Проверка файла кэша маршрутизатора: неповреждённый файл загружается, а обрезанный
+// или с подменёнными размерами в заголовке отбрасывается, и маршрутизатор строится заново.
+// В любом случае ответы Route совпадают с маршрутизатором без кэша. Подменённые размеры
+// подобраны так, что без проверок заголовка смещения переполнились бы и сошлись с размером файла
+
+using transport_router::RouterMode;
+using transport_router::RoutingSetting;
+using transport_router::TransportRouter;
+
+namespace {
+	constexpr int GRID_SIZE = 5;
+
+	// Смещения полей CacheHeader в transport_router.cpp
+	constexpr size_t VERTEX_COUNT_OFFSET = 24;
+	constexpr size_t EDGE_COUNT_OFFSET = 32;
+	constexpr size_t NAMES_SIZE_OFFSET = 40;
+
+	std::string StopName(int row, int column) {
+		return "Stop " + std::to_string(row) + "-" + std::to_string(column);
+	}
+
+	// Сетка остановок с некольцевым автобусом по каждой строке и каждому столбцу
+	void FillCatalogue(TransportCatalogue& catalogue) {
+		std::mt19937 random(3);
+		std::uniform_int_distribution<size_t> distance(300, 3000);
+		for (int row = 0; row < GRID_SIZE; ++row) {
+			for (int column = 0; column < GRID_SIZE; ++column) {
+				catalogue.AddStop({ .name = StopName(row, column), .geo_point = { 55.6 + 0.01 * row, 37.5 + 0.015 * column } });
+			}
+		}
+		for (int line = 0; line < GRID_SIZE; ++line) {
+			for (bool is_row : { true, false }) {
+				std::vector<const BusStop*> stops;
+				for (int i = 0; i < GRID_SIZE; ++i) {
+					stops.push_back(catalogue.GetStop(is_row ? StopName(line, i) : StopName(i, line)));
+				}
+				for (size_t i = 1; i < stops.size(); ++i) {
+					catalogue.SetStopsDistance({ stops[i - 1], stops[i] }, distance(random));
+				}
+				const std::vector<const BusStop*> backward{ std::next(stops.rbegin()), stops.rend() };
+				stops.insert(stops.end(), backward.begin(), backward.end());
+				catalogue.AddRoute({ .name = (is_row ? "Row " : "Column ") + std::to_string(line), .driving_route = std::move(stops), .round_trip = false });
+			}
+		}
+		catalogue.Finalize();
+	}
+
+	std::string ReadFile(const std::filesystem::path& path) {
+		std::ifstream input(path, std::ios::binary);
+		return { std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>() };
+	}
+
+	void WriteFile(const std::filesystem::path& path, const std::string& content) {
+		std::ofstream output(path, std::ios::binary | std::ios::trunc);
+		output.write(content.data(), static_cast<std::streamsize>(content.size()));
+	}
+
+	uint64_t GetField(const std::string& content, size_t offset) {
+		uint64_t value = 0;
+		std::memcpy(&value, content.data() + offset, sizeof(value));
+		return value;
+	}
+
+	std::string SetField(std::string content, size_t offset, uint64_t value) {
+		std::memcpy(content.data() + offset, &value, sizeof(value));
+		return content;
+	}
+
+	struct Case {
+		std::string name;
+		std::string content;
+		bool loaded = false;
+	};
+
+	std::vector<Case> GetCases(const std::string& saved) {
+		const uint64_t vertex_count = GetField(saved, VERTEX_COUNT_OFFSET);
+		const uint64_t edge_count = GetField(saved, EDGE_COUNT_OFFSET);
+		return {
+			{ .name = "valid", .content = saved, .loaded = true },
+			{ .name = "truncated by half", .content = saved.substr(0, saved.size() / 2) },
+			{ .name = "truncated by one byte", .content = saved.substr(0, saved.size() - 1) },
+			{ .name = "header only", .content = saved.substr(0, 64) },
+			// 24 * 2^61 кратно 2^64: размер секции рёбер не меняется
+			{ .name = "edge_count overflow", .content = SetField(saved, EDGE_COUNT_OFFSET, edge_count + (uint64_t{ 1 } << 61)) },
+			// (v + 2^63)^2 совпадает с v^2 по модулю 2^64: размер таблицы не меняется
+			{ .name = "vertex_count overflow", .content = SetField(saved, VERTEX_COUNT_OFFSET, vertex_count + (uint64_t{ 1 } << 63)) },
+			{ .name = "vertex_count too large", .content = SetField(saved, VERTEX_COUNT_OFFSET, vertex_count + 2) },
+			{ .name = "names_size too large", .content = SetField(saved, NAMES_SIZE_OFFSET, ~uint64_t{ 0 } - 7) }
+		};
+	}
+
+	// Число пар остановок, ответ по которым отличается от маршрутизатора без кэша
+	size_t CompareRoutes(const TransportCatalogue& catalogue, const TransportRouter& router, const TransportRouter& expected) {
+		size_t mismatches = 0;
+		for (StopId from = 0; from < catalogue.GetStopCount(); ++from) {
+			for (StopId to = 0; to < catalogue.GetStopCount(); ++to) {
+				const std::string& from_name = catalogue.GetStopById(from).name;
+				const std::string& to_name = catalogue.GetStopById(to).name;
+				const auto actual = router.BuildRoute(from_name, to_name);
+				const auto reference = expected.BuildRoute(from_name, to_name);
+				const bool same = actual.has_value() == reference.has_value()
+					&& (!actual || (actual->total_weight == reference->total_weight && actual->route.size() == reference->route.size()));
+				mismatches += same ? 0 : 1;
+			}
+		}
+		return mismatches;
+	}
+
+	// Инициализация с перехватом std::clog: по сообщению видно, был ли загружен файл
+	bool InitializeWithCache(TransportRouter& router) {
+		std::ostringstream log;
+		std::streambuf* const clog_buffer = std::clog.rdbuf(log.rdbuf());
+		router.Initialization();
+		std::clog.rdbuf(clog_buffer);
+		return log.str().find("router cache: loaded") != std::string::npos;
+	}
+
+	size_t CheckMode(const std::string& mode_name, RoutingSetting setting, const std::filesystem::path& cache_file) {
+		TransportCatalogue catalogue;
+		FillCatalogue(catalogue);
+
+		TransportRouter expected(catalogue);
+		expected.SetSetting(setting);
+		expected.Initialization();
+
+		setting.cache_file = cache_file.string();
+		setting.cache_key = 1;
+		std::filesystem::remove(cache_file);
+		TransportRouter writer(catalogue);
+		writer.SetSetting(setting);
+		InitializeWithCache(writer);
+		const std::string saved = ReadFile(cache_file);
+
+		size_t failures = 0;
+		for (const Case& test_case : GetCases(saved)) {
+			WriteFile(cache_file, test_case.content);
+			TransportRouter router(catalogue);
+			router.SetSetting(setting);
+			const bool loaded = InitializeWithCache(router);
+			const size_t mismatches = CompareRoutes(catalogue, router, expected);
+			const bool ok = loaded == test_case.loaded && mismatches == 0;
+			std::cout << mode_name << ", " << test_case.name << ": "
+				<< (ok ? "ok" : std::string(loaded ? "loaded" : "rebuilt") + ", " + std::to_string(mismatches) + " mismatches") << "\n";
+			failures += ok ? 0 : 1;
+		}
+		return failures;
+	}
+} // namespace
+
+int main() {
+	const std::filesystem::path cache_file = std::filesystem::temp_directory_path()
+		/ ("router_cache_check_" + std::to_string(std::random_device{}()) + ".bin");
+	const RoutingSetting base{ .bus_wait = 6, .bus_velocity = 40 };
+	size_t failures = 0;
+	for (const auto& [name, mode, compact_table] : std::vector<std::tuple<std::string, RouterMode, bool>>{
+		{ "dijkstra", RouterMode::DIJKSTRA, false },
+		{ "all_pairs", RouterMode::ALL_PAIRS, false },
+		{ "all_pairs compact_table", RouterMode::ALL_PAIRS, true } }) {
+		RoutingSetting setting = base;
+		setting.mode = mode;
+		setting.compact_table = compact_table;
+		failures += CheckMode(name, setting, cache_file);
+	}
+	std::filesystem::remove(cache_file);
+	return failures == 0 ? 0 : 1;
+}
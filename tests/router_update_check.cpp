@@ -0,0 +1,219 @@
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+#include <iterator>
+#include <optional>
+#include <random>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "transport_catalogue.h"
+#include "transport_router.h"
+
+// Проверка TransportRouter::Update: после каждого изменения каталога ответы Route
+// обновлённого маршрутизатора сравниваются с маршрутизатором, построенным заново.
+// Сравниваются достижимость и общее время; при равных по времени вариантах маршруты
+// могут отличаться составом, поэтому у обновлённого ответа проверяется только сумма участков.
+// Кэш ответов вмещает все пары, так что несброшенный кэш тоже даёт расхождения
+
+using transport_router::RouterMode;
+using transport_router::RoutingSetting;
+using transport_router::Time;
+using transport_router::TransportRouter;
+
+namespace {
+	constexpr int GRID_SIZE = 6;
+
+	std::string StopName(int row, int column) {
+		return "Stop " + std::to_string(row) + "-" + std::to_string(column);
+	}
+
+	// Маршрут в том виде, в каком его добавляет request_handler::CatalogueFiller
+	void AddBus(TransportCatalogue& catalogue, const std::string& name, const std::vector<std::string>& stop_names, bool is_roundtrip) {
+		std::vector<const BusStop*> stops;
+		for (const std::string& stop_name : stop_names) {
+			stops.push_back(catalogue.GetStop(stop_name));
+		}
+		if (!is_roundtrip) {
+			const std::vector<const BusStop*> backward{ std::next(stops.rbegin()), stops.rend() };
+			stops.insert(stops.end(), backward.begin(), backward.end());
+		}
+		catalogue.AddRoute({ .name = name, .driving_route = std::move(stops), .round_trip = is_roundtrip });
+	}
+
+	void SetDistance(TransportCatalogue& catalogue, const std::string& from, const std::string& to, size_t distance) {
+		catalogue.SetStopsDistance({ catalogue.GetStop(from), catalogue.GetStop(to) }, distance);
+	}
+
+	// Сетка остановок GRID_SIZE x GRID_SIZE: автобус по каждой строке и по каждому столбцу,
+	// чётные - кольцевые, и расстояния между соседями в одну сторону
+	void FillCatalogue(TransportCatalogue& catalogue) {
+		std::mt19937 random(42);
+		std::uniform_int_distribution<size_t> distance(300, 3000);
+		for (int row = 0; row < GRID_SIZE; ++row) {
+			for (int column = 0; column < GRID_SIZE; ++column) {
+				catalogue.AddStop({ .name = StopName(row, column), .geo_point = { 55.6 + 0.01 * row, 37.5 + 0.015 * column } });
+			}
+		}
+		for (int line = 0; line < GRID_SIZE; ++line) {
+			std::vector<std::string> row_stops;
+			std::vector<std::string> column_stops;
+			for (int i = 0; i < GRID_SIZE; ++i) {
+				row_stops.push_back(StopName(line, i));
+				column_stops.push_back(StopName(i, line));
+			}
+			const bool is_roundtrip = line % 2 == 0;
+			if (is_roundtrip) {
+				row_stops.push_back(row_stops.front());
+				column_stops.push_back(column_stops.front());
+			}
+			AddBus(catalogue, "Row " + std::to_string(line), row_stops, is_roundtrip);
+			AddBus(catalogue, "Column " + std::to_string(line), column_stops, is_roundtrip);
+			for (size_t i = 1; i < row_stops.size(); ++i) {
+				SetDistance(catalogue, row_stops[i - 1], row_stops[i], distance(random));
+				SetDistance(catalogue, column_stops[i - 1], column_stops[i], distance(random));
+			}
+		}
+		catalogue.Finalize();
+	}
+
+	struct Mode {
+		std::string name;
+		RoutingSetting setting;
+	};
+
+	std::vector<Mode> GetModes() {
+		const RoutingSetting base{ .bus_wait = 6, .bus_velocity = 40, .route_cache_size = 4096 };
+		std::vector<Mode> modes;
+		for (const auto& [name, mode] : std::vector<std::pair<std::string, RouterMode>>{
+			{ "dijkstra", RouterMode::DIJKSTRA },
+			{ "all_pairs", RouterMode::ALL_PAIRS },
+			{ "contraction_hierarchy", RouterMode::CONTRACTION_HIERARCHY },
+			{ "a_star", RouterMode::A_STAR },
+			{ "bidirectional_dijkstra", RouterMode::BIDIRECTIONAL_DIJKSTRA },
+			{ "raptor", RouterMode::RAPTOR } }) {
+			RoutingSetting setting = base;
+			setting.mode = mode;
+			modes.push_back({ name, setting });
+		}
+		RoutingSetting compact = base;
+		compact.mode = RouterMode::ALL_PAIRS;
+		compact.compact_table = true;
+		modes.push_back({ "all_pairs compact_table", compact });
+		return modes;
+	}
+
+	std::vector<std::string> GetStopNames(const TransportCatalogue& catalogue) {
+		std::vector<std::string> names;
+		for (StopId id = 0; id < catalogue.GetStopCount(); ++id) {
+			names.push_back(catalogue.GetStopById(id).name);
+		}
+		return names;
+	}
+
+	Time GetItemsTime(const transport_router::InfoBuildRoute& route) {
+		Time total = 0;
+		for (const transport_router::EdgeInfo& item : route.route) {
+			total += std::visit([](const auto& edge) { return edge.time; }, item);
+		}
+		return total;
+	}
+
+	bool IsClose(Time lhs, Time rhs, bool compact_table) {
+		const Time tolerance = compact_table ? 1e-4 : 1e-9;
+		return std::abs(lhs - rhs) <= tolerance * std::max(1.0, std::abs(rhs));
+	}
+
+	// Число расхождений по всем упорядоченным парам остановок
+	size_t CompareWithRebuild(const TransportCatalogue& catalogue, const TransportRouter& updated, const Mode& mode, const std::string& step) {
+		TransportRouter rebuilt(catalogue);
+		rebuilt.SetSetting(mode.setting);
+		rebuilt.Initialization();
+
+		size_t mismatches = 0;
+		const std::vector<std::string> names = GetStopNames(catalogue);
+		for (const std::string& from : names) {
+			for (const std::string& to : names) {
+				const auto actual = updated.BuildRoute(from, to);
+				const auto expected = rebuilt.BuildRoute(from, to);
+				const bool same = actual.has_value() == expected.has_value()
+					&& (!actual || (IsClose(actual->total_weight, expected->total_weight, mode.setting.compact_table)
+						&& IsClose(GetItemsTime(*actual), actual->total_weight, mode.setting.compact_table)));
+				if (!same) {
+					if (mismatches == 0) {
+						std::cerr << mode.name << ", " << step << ": " << from << " -> " << to << " differs from full rebuild\n";
+					}
+					++mismatches;
+				}
+			}
+		}
+		return mismatches;
+	}
+
+	// Запросы по всем парам до изменения заполняют кэш ответов, который Update обязан сбросить
+	void WarmUp(const TransportCatalogue& catalogue, const TransportRouter& router) {
+		const std::vector<std::string> names = GetStopNames(catalogue);
+		for (const std::string& from : names) {
+			for (const std::string& to : names) {
+				router.BuildRoute(from, to);
+			}
+		}
+	}
+
+	size_t CheckMode(const Mode& mode) {
+		TransportCatalogue catalogue;
+		FillCatalogue(catalogue);
+		TransportRouter router(catalogue);
+		router.SetSetting(mode.setting);
+		router.Initialization();
+
+		struct Step {
+			std::string name;
+			void (*apply)(TransportCatalogue& catalogue);
+		};
+		const std::vector<Step> steps{
+			{ "distance increase", [](TransportCatalogue& catalogue) {
+				catalogue.UpdateStopsDistance({ catalogue.GetStop(StopName(2, 2)), catalogue.GetStop(StopName(2, 3)) }, 9000);
+			} },
+			{ "distance decrease", [](TransportCatalogue& catalogue) {
+				catalogue.UpdateStopsDistance({ catalogue.GetStop(StopName(3, 0)), catalogue.GetStop(StopName(4, 0)) }, 50);
+			} },
+			{ "bus removal", [](TransportCatalogue& catalogue) {
+				catalogue.RemoveRoute("Row 1");
+			} },
+			{ "bus addition", [](TransportCatalogue& catalogue) {
+				catalogue.AddStop({ .name = "Stop new", .geo_point = { 55.63, 37.56 } });
+				AddBus(catalogue, "Diagonal", { StopName(0, 0), "Stop new", StopName(5, 5) }, false);
+				SetDistance(catalogue, StopName(0, 0), "Stop new", 700);
+				SetDistance(catalogue, "Stop new", StopName(5, 5), 800);
+			} },
+			{ "two removals", [](TransportCatalogue& catalogue) {
+				catalogue.RemoveRoute("Column 0");
+				catalogue.RemoveRoute("Row 4");
+			} }
+		};
+
+		size_t mismatches = 0;
+		for (const Step& step : steps) {
+			WarmUp(catalogue, router);
+			step.apply(catalogue);
+			catalogue.Finalize();
+			router.Update();
+			mismatches += CompareWithRebuild(catalogue, router, mode, step.name);
+		}
+		return mismatches;
+	}
+} // namespace
+
+int main() {
+	size_t failed_modes = 0;
+	for (const Mode& mode : GetModes()) {
+		const size_t mismatches = CheckMode(mode);
+		std::cout << mode.name << ": " << (mismatches == 0 ? "ok" : std::to_string(mismatches) + " mismatches") << "\n";
+		failed_modes += mismatches == 0 ? 0 : 1;
+	}
+	return failed_modes == 0 ? 0 : 1;
+}
@@ -0,0 +1,189 @@
+#include <cstddef>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "json.h"
+#include "json_reader.h"
+#include "map_renderer.h"
+#include "transport_catalogue.h"
+#include "transport_router.h"
+
+// Проверка stat_settings.threads: ответ при нескольких потоках должен совпадать
+// с ответом при одном потоке байт в байт. Вход содержит запросы всех видов,
+// в том числе RouteMatrix, которые при нескольких потоках считаются без вложенных потоков
+// маршрутизатора, и кэш ответов Route, общий для потоков
+
+namespace {
+	constexpr int GRID_SIZE = 8;
+	constexpr int REQUEST_COUNT = 400;
+
+	std::string StopName(int row, int column) {
+		return "Stop " + std::to_string(row) + "-" + std::to_string(column);
+	}
+
+	json::Dict MakeRenderSettings() {
+		json::Dict settings;
+		settings.emplace("width", 600);
+		settings.emplace("height", 400);
+		settings.emplace("padding", 30);
+		settings.emplace("line_width", 8);
+		settings.emplace("stop_radius", 4);
+		settings.emplace("bus_label_font_size", 16);
+		settings.emplace("bus_label_offset", json::Array{ 7, 15 });
+		settings.emplace("stop_label_font_size", 12);
+		settings.emplace("stop_label_offset", json::Array{ 7, -3 });
+		settings.emplace("underlayer_color", json::Array{ 255, 255, 255, 0.85 });
+		settings.emplace("underlayer_width", 3);
+		settings.emplace("color_palette", json::Array{ std::string("green"), json::Array{ 255, 160, 0 }, std::string("red") });
+		return settings;
+	}
+
+	json::Dict MakeBus(std::string name, json::Array stops) {
+		json::Dict bus;
+		bus.emplace("type", std::string("Bus"));
+		bus.emplace("name", std::move(name));
+		bus.emplace("stops", std::move(stops));
+		bus.emplace("is_roundtrip", false);
+		return bus;
+	}
+
+	// Сетка остановок с автобусами по строкам и столбцам и случайные запросы к ней
+	json::Dict MakeInput() {
+		std::mt19937 random(7);
+		std::uniform_int_distribution<int> coordinate(0, GRID_SIZE - 1);
+		std::uniform_int_distribution<int> distance(300, 3000);
+		const auto random_stop = [&] { return StopName(coordinate(random), coordinate(random)); };
+
+		json::Array base_requests;
+		for (int row = 0; row < GRID_SIZE; ++row) {
+			for (int column = 0; column < GRID_SIZE; ++column) {
+				json::Dict road_distances;
+				if (column + 1 < GRID_SIZE) {
+					road_distances.emplace(StopName(row, column + 1), distance(random));
+				}
+				if (row + 1 < GRID_SIZE) {
+					road_distances.emplace(StopName(row + 1, column), distance(random));
+				}
+				json::Dict stop;
+				stop.emplace("type", std::string("Stop"));
+				stop.emplace("name", StopName(row, column));
+				stop.emplace("latitude", 55.6 + 0.01 * row);
+				stop.emplace("longitude", 37.5 + 0.015 * column);
+				stop.emplace("road_distances", std::move(road_distances));
+				base_requests.emplace_back(std::move(stop));
+			}
+		}
+		for (int line = 0; line < GRID_SIZE; ++line) {
+			json::Array row_stops;
+			json::Array column_stops;
+			for (int i = 0; i < GRID_SIZE; ++i) {
+				row_stops.emplace_back(StopName(line, i));
+				column_stops.emplace_back(StopName(i, line));
+			}
+			base_requests.emplace_back(MakeBus("Row " + std::to_string(line), std::move(row_stops)));
+			base_requests.emplace_back(MakeBus("Column " + std::to_string(line), std::move(column_stops)));
+		}
+
+		json::Array stat_requests;
+		for (int id = 1; id <= REQUEST_COUNT; ++id) {
+			json::Dict request;
+			request.emplace("id", id);
+			switch (id % 6) {
+			case 0:
+				request.emplace("type", std::string("Bus"));
+				request.emplace("name", "Row " + std::to_string(coordinate(random)));
+				break;
+			case 1:
+				request.emplace("type", std::string("Stop"));
+				request.emplace("name", random_stop());
+				break;
+			case 2:
+			case 3:
+				// Повторы пар попадают в кэш ответов
+				request.emplace("type", std::string("Route"));
+				request.emplace("from", StopName(coordinate(random) / 2, coordinate(random)));
+				request.emplace("to", StopName(coordinate(random) / 2, coordinate(random)));
+				break;
+			case 4: {
+				json::Array origins;
+				json::Array destinations;
+				for (int i = 0; i < 6; ++i) {
+					origins.emplace_back(random_stop());
+					destinations.emplace_back(random_stop());
+				}
+				request.emplace("type", std::string("RouteMatrix"));
+				request.emplace("origins", std::move(origins));
+				request.emplace("destinations", std::move(destinations));
+				break;
+			}
+			default:
+				request.emplace("type", std::string(id % 12 == 5 ? "Nearby" : "Nearest"));
+				request.emplace("latitude", 55.6 + 0.07 * coordinate(random) / GRID_SIZE);
+				request.emplace("longitude", 37.5 + 0.1 * coordinate(random) / GRID_SIZE);
+				request.emplace("radius", 1500);
+				request.emplace("count", 5);
+				break;
+			}
+			stat_requests.emplace_back(std::move(request));
+		}
+		json::Dict map_request;
+		map_request.emplace("id", REQUEST_COUNT + 1);
+		map_request.emplace("type", std::string("Map"));
+		stat_requests.emplace_back(std::move(map_request));
+
+		json::Dict input;
+		input.emplace("base_requests", std::move(base_requests));
+		input.emplace("render_settings", MakeRenderSettings());
+		input.emplace("stat_requests", std::move(stat_requests));
+		return input;
+	}
+
+	// Тот же порядок вызовов, что в main
+	std::string Run(json::Dict input, const std::string& router_mode, int routing_threads, int stat_threads) {
+		json::Dict routing_settings;
+		routing_settings.emplace("bus_wait_time", 6);
+		routing_settings.emplace("bus_velocity", 40);
+		routing_settings.emplace("router_mode", router_mode);
+		routing_settings.emplace("threads", routing_threads);
+		routing_settings.emplace("route_cache_size", 64);
+		json::Dict stat_settings;
+		stat_settings.emplace("threads", stat_threads);
+		input.emplace("routing_settings", std::move(routing_settings));
+		input.emplace("stat_settings", std::move(stat_settings));
+		std::ostringstream text;
+		json::PrintNode(json::Node{ std::move(input) }, text);
+
+		TransportCatalogue catalogue;
+		json_reader::Reader reader;
+		map_renderer::Renderer renderer;
+		transport_router::TransportRouter router(catalogue);
+		std::istringstream is(text.str());
+		reader.LoadDoc(is, catalogue);
+		reader.SetSettingRenderer(renderer);
+		reader.SetSettingRouter(router);
+		renderer.CreateMap(catalogue);
+		reader.GetData(catalogue, renderer, router);
+		std::ostringstream output;
+		reader.PrintDoc(output);
+		return output.str();
+	}
+} // namespace
+
+int main() {
+	const json::Dict input = MakeInput();
+	size_t failures = 0;
+	for (const std::string mode : { "dijkstra", "all_pairs", "raptor" }) {
+		const std::string expected = Run(input, mode, 1, 1);
+		for (const auto& [routing_threads, stat_threads] : std::vector<std::pair<int, int>>{ { 1, 4 }, { 0, 4 }, { 0, 0 }, { 3, 1 } }) {
+			const bool same = Run(input, mode, routing_threads, stat_threads) == expected;
+			std::cout << mode << ", routing threads " << routing_threads << ", stat threads " << stat_threads
+				<< ": " << (same ? "ok" : "differs from a single thread") << "\n";
+			failures += same ? 0 : 1;
+		}
+	}
+	return failures == 0 ? 0 : 1;
+}